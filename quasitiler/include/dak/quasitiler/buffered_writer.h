@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_BUFFERED_WRITER_H
+#define DAK_QUASITILER_BUFFERED_WRITER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Write a file on a background thread.
+   //
+   // The data is appended to a buffer that is handed to the background
+   // thread once full, so that formatting and writing overlap. At most a
+   // few full buffers wait to be written: when they are all waiting,
+   // handing a new one blocks until one is written, which keeps the memory
+   // used flat however large the file.
+   //
+   // The writer is used from a single thread, except for its own
+   // background thread.
+
+   struct buffered_writer_t
+   {
+      // Create a writer with the given buffer size and maximum number of
+      // buffers waiting to be written.
+      buffered_writer_t(size_t a_buffer_size = 1 << 20, size_t a_max_pending_count = 4);
+      buffered_writer_t(const buffered_writer_t&) = delete;
+      buffered_writer_t& operator=(const buffered_writer_t&) = delete;
+      ~buffered_writer_t();
+
+      // Create the file and start the background thread.
+      // Returns false if the file cannot be created.
+      bool open(const std::filesystem::path& a_file_name);
+
+      // Write the remaining data, stop the background thread and close the file.
+      // Returns false if any of the data could not be written.
+      bool close();
+
+      bool is_open() const { return my_file != nullptr; }
+
+      // The buffer to which the data is appended. Call commit() after
+      // appending to it so that it is written once full.
+      std::string& buffer() { return my_buffer; }
+      void commit()         { if (my_buffer.size() >= my_buffer_size) hand_off(); }
+
+      void write(std::string_view some_data) { my_buffer += some_data; commit(); }
+
+   private:
+      // Give the current buffer to the background thread and take a free one.
+      void hand_off();
+
+      // Background thread: write the pending buffers in order.
+      void write_pending();
+
+      const size_t               my_buffer_size;
+      const size_t               my_max_pending_count;
+      std::FILE*                 my_file = nullptr;
+      std::string                my_buffer;
+
+      // Shared with the background thread.
+      std::mutex                 my_mutex;
+      std::condition_variable    my_changed;
+      std::deque<std::string>    my_pending;
+      std::vector<std::string>   my_free;
+      bool                       my_is_closing = false;
+      bool                       my_has_failed = false;
+      std::thread                my_thread;
+   };
+}
+
+#endif /* DAK_QUASITILER_BUFFERED_WRITER_H */
@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_CHUNKED_DRAWING_H
+#define DAK_QUASITILER_CHUNKED_DRAWING_H
+
+#include <dak/quasitiler/drawing.h>
+
+#include <memory>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Receives the chunks of a chunked drawing.
+
+   struct chunk_reporter_t
+   {
+      virtual ~chunk_reporter_t() = default;
+
+      // Receives a chunk once its tiles are located. Its tile storage only
+      // contains the tiles that the chunk owns, while its vertex storage also
+      // contains the vertices of the halo. The chunk is released after the call.
+      virtual void report_chunk(const drawing_t& a_chunk) = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Generate and locate the tiles of a large region one rectangular chunk
+   // at a time, so that the memory used grows with the chunk size instead
+   // of the region size.
+   //
+   // Each chunk is generated with a halo around it, wide enough that its
+   // tiles are located as if the whole region had been generated. Each tile
+   // is owned by the chunk containing its center, so it is reported once.
+   //
+   // The tiles reported are all those whose center is within the largest
+   // tile size of the tiling bounds, which includes all the tiles
+   // intersecting the tiling bounds.
+
+   struct chunked_drawing_t
+   {
+      // Constructor, associate the drawing with the given tiling.
+      chunked_drawing_t(std::shared_ptr<tiling_t> a_tiling) : my_tiling(a_tiling) { }
+
+      std::shared_ptr<tiling_t> get_tiling() const { return my_tiling; }
+
+      // Width and height of the chunks, in tiling coordinates.
+      double get_chunk_size() const             { return my_chunk_size; }
+      void   set_chunk_size(double a_chunk_size) { my_chunk_size = a_chunk_size; }
+
+      // Select how the tiles of each chunk are located.
+      drawing_t::tile_search_t get_tile_search() const                            { return my_tile_search; }
+      void                     set_tile_search(drawing_t::tile_search_t a_search) { my_tile_search = a_search; }
+
+      // Number of threads generating each chunk and locating its tiles, as
+      // given to tiling_t::generate() and drawing_t::locate_tiles().
+      int  get_thread_count() const               { return my_thread_count; }
+      void set_thread_count(int a_thread_count)   { my_thread_count = a_thread_count; }
+
+      // Generate the chunks covering the tiling bounds, one row of chunks
+      // at a time, and report each chunk once its tiles are located.
+      //
+      // The interruptor is called periodically to provide a way of stopping
+      // the computation; should return true for the computation to stop.
+      //
+      // generate() returns false if it cannot finish the computation for
+      // any reason.
+      bool generate(double tiling_bounds[2][tiling_t::MAX_DIM], chunk_reporter_t& reporter, interruptor_t& an_interruptor);
+
+      // The center of the tile of the given combination at the given vertex,
+      // in tiling coordinates.
+      tiling_point_t get_tile_center(int a_tile_comb, const vertex_t& a_vertex) const;
+
+   private:
+      // The longest projection of the lattice generators in the tiling plane.
+      // No tile corner is further than that from the tile center.
+      double get_generator_reach() const;
+
+      std::shared_ptr<tiling_t>  my_tiling;
+      double                     my_chunk_size = 50.;
+      drawing_t::tile_search_t   my_tile_search = drawing_t::tile_search_t::hashed;
+      int                        my_thread_count = 1;
+   };
+}
+
+#endif /* DAK_QUASITILER_CHUNKED_DRAWING_H */
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_CPU_FEATURES_H
+#define DAK_QUASITILER_CPU_FEATURES_H
+
+////////////////////////////////////////////////////////////////////////////
+//
+// Instruction sets of the vectorized kernels.
+//
+// DAK_QUASITILER_HAS_X86_SIMD is defined when compiling for a CPU with at
+// least SSE2, and the intrinsics are then available. Functions using a
+// wider instruction set are marked with DAK_QUASITILER_TARGET() and must
+// only be called when the running CPU supports it.
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+   #define DAK_QUASITILER_HAS_X86_SIMD
+   #include <immintrin.h>
+   #if defined(_MSC_VER)
+      #include <intrin.h>
+   #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+   #define DAK_QUASITILER_TARGET(isa) __attribute__((target(isa)))
+#else
+   #define DAK_QUASITILER_TARGET(isa)
+#endif
+
+
+namespace dak::quasitiler
+{
+   // Verify that the CPU and the OS support AVX2.
+   bool is_avx2_supported();
+}
+
+#endif /* DAK_QUASITILER_CPU_FEATURES_H */
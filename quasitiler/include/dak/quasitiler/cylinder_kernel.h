@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_CYLINDER_KERNEL_H
+#define DAK_QUASITILER_CYLINDER_KERNEL_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // The criteria of the cylinder around the tiling plane, transposed:
+   // each column holds the coefficient of one coordinate for all criteria,
+   // so a vector register can work on consecutive criteria.
+   //
+   // The columns are aligned and padded with zero criteria up to a multiple
+   // of the widest vector, so kernels never need a scalar tail loop.
+
+   struct cylinder_columns_t
+   {
+      // Maximum number of criteria: the combinations of three dimensions.
+      static constexpr int MAX_DIM = vertex_t::MAX_DIM;
+      static constexpr int MAX_CRITERIA = MAX_DIM * (MAX_DIM - 1) * (MAX_DIM - 2) / 6;
+
+      // Criteria are processed in groups of this size.
+      static constexpr int CRITERIA_ALIGN = 4;
+      static constexpr int MAX_PADDED_CRITERIA = (MAX_CRITERIA + CRITERIA_ALIGN - 1) / CRITERIA_ALIGN * CRITERIA_ALIGN;
+
+      alignas(32) double   columns[MAX_DIM][MAX_PADDED_CRITERIA] = { };
+      int                  dimensions_count = 0;
+      int                  criteria_count = 0;
+      int                  padded_criteria_count = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vectorized evaluation of the cylinder criteria.
+   //
+   // All kernels do the multiplications and additions separately and in
+   // the same order as the scalar code, so they round identically and
+   // accept and reject exactly the same points.
+
+   struct cylinder_kernel_t
+   {
+      // Values of the running criteria relative to the faces of the cylinder.
+      enum class position_t
+      {
+         outside,
+         uncertain,
+         inside,
+      };
+
+      // Name of the instruction set used.
+      const char* name;
+
+      // Compute the value of all the criteria for a point already
+      // translated by the tiling offset. Fills padded_criteria_count values.
+      void (*evaluate)(const cylinder_columns_t& some_columns, const double a_trans_point[], double some_values[]);
+
+      // Check if a point, already translated by the tiling offset, is
+      // at least epsilon inside all the criteria.
+      bool (*contains)(const cylinder_columns_t& some_columns, const double a_trans_point[], double an_epsilon);
+
+      // Add a multiple of a column to the criteria values.
+      void (*move)(const cylinder_columns_t& some_columns, int a_coord, double a_delta, double some_values[]);
+
+      // Classify criteria values: outside if any absolute value is above the
+      // outside limit, uncertain if any is at or above the inside limit.
+      position_t (*classify)(const cylinder_columns_t& some_columns, const double some_values[], double an_inside_limit, double an_outside_limit);
+   };
+
+   // The kernel for the best instruction set supported by the running CPU.
+   //
+   // When given a dimension count, the kernel is specialized for it and must
+   // only be used with columns of that dimension. Otherwise, or for
+   // dimensions without a specialization, it works for any dimension.
+   const cylinder_kernel_t& get_cylinder_kernel(int a_dimensions_count = 0);
+
+   // The kernels for specific instruction sets. The SIMD ones return
+   // nullptr when the running CPU does not support them.
+   const cylinder_kernel_t& get_scalar_cylinder_kernel(int a_dimensions_count = 0);
+   const cylinder_kernel_t* get_sse2_cylinder_kernel(int a_dimensions_count = 0);
+   const cylinder_kernel_t* get_avx2_cylinder_kernel(int a_dimensions_count = 0);
+}
+
+#endif /* DAK_QUASITILER_CYLINDER_KERNEL_H */
@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_DIMENSION_DISPATCH_H
+#define DAK_QUASITILER_DIMENSION_DISPATCH_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Dispatch a runtime dimension count to code specialized for it.
+   //
+   // Calls a_function.template operator()<DIM>() with DIM being the given
+   // dimension count as a compile-time constant, for the dimensions that
+   // have a specialization, or zero for the others. Code specialized this way
+   // uses dimension_count<DIM>(a_dimensions_count) for its loops, which
+   // is a constant whenever DIM is not zero.
+
+   static constexpr int MIN_SPECIALIZED_DIM = 3;
+   static constexpr int MAX_SPECIALIZED_DIM = vertex_t::MAX_DIM;
+
+   template <int DIM>
+   constexpr int dimension_count(int a_dimensions_count)
+   {
+      if constexpr (DIM > 0)
+         return DIM;
+      else
+         return a_dimensions_count;
+   }
+
+   template <class FUNCTION>
+   decltype(auto) dispatch_dimension(int a_dimensions_count, FUNCTION&& a_function)
+   {
+      static_assert(MIN_SPECIALIZED_DIM == 3 && MAX_SPECIALIZED_DIM == 8, "Update the dispatch cases.");
+
+      switch (a_dimensions_count)
+      {
+         case 3:  return a_function.template operator()<3>();
+         case 4:  return a_function.template operator()<4>();
+         case 5:  return a_function.template operator()<5>();
+         case 6:  return a_function.template operator()<6>();
+         case 7:  return a_function.template operator()<7>();
+         case 8:  return a_function.template operator()<8>();
+         default: return a_function.template operator()<0>();
+      }
+   }
+}
+
+#endif /* DAK_QUASITILER_DIMENSION_DISPATCH_H */
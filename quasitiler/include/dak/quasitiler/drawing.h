@@ -4,6 +4,9 @@
 #define DAK_QUASITILER_DRAWING_H
 
 #include <dak/quasitiler/point_reporter.h>
+#include <dak/quasitiler/packed_vertex.h>
+#include <dak/quasitiler/projection_kernel.h>
+#include <dak/quasitiler/stats.h>
 #include <dak/quasitiler/tiling.h>
 
 #include <memory>
@@ -19,7 +22,35 @@ namespace dak::quasitiler
    struct drawing_t : point_reporter_t
    {
       using tile_list_t = std::vector<size_t>;
-      using vertex_list_t = std::vector<vertex_t>;
+      using vertex_list_t = packed_vertex_list_t;
+
+      // How locate_tiles() finds the neighbors of a vertex.
+      //
+      // sorted: radix-sort the vertices and binary-search each neighbor.
+      // hashed: index the vertices in a hash table and look up each neighbor.
+      //         The vertices are left in the order they were reported.
+      enum class tile_search_t
+      {
+         sorted,
+         hashed,
+      };
+
+      // How the vertices are ordered once their tiles are located.
+      //
+      // located: as locate_tiles() leaves them: sorted by lattice coordinates
+      //          with the sorted search, in the order reported with the hashed one.
+      // morton:  along a Morton curve of their position in the tiling plane.
+      // hilbert: along a Hilbert curve of their position in the tiling plane.
+      //
+      // Along a curve, vertices close in the tiling plane are mostly close
+      // in memory, and so are their tiles, which follow the order of their
+      // vertex. The Hilbert curve keeps them closer than the Morton curve.
+      enum class vertex_order_t
+      {
+         located,
+         morton,
+         hilbert,
+      };
 
       // Constructor, associate the drawing with the given tiling.
       drawing_t(std::shared_ptr<tiling_t> a_tiling) : my_tiling(a_tiling) { }
@@ -29,12 +60,31 @@ namespace dak::quasitiler
       const tile_list_t*        get_tile_storage() const   { return my_tile_storage; }
       std::shared_ptr<tiling_t> get_tiling() const         { return my_tiling; }
 
+      // Select how the tiles are located.
+      tile_search_t get_tile_search() const                 { return my_tile_search; }
+      void          set_tile_search(tile_search_t a_search) { my_tile_search = a_search; }
+
+      // Select how the vertices are ordered.
+      vertex_order_t get_vertex_order() const                { return my_vertex_order; }
+      void           set_vertex_order(vertex_order_t an_order) { my_vertex_order = an_order; }
+
+      // The position of each vertex in the tiling plane, in the order of
+      // the vertices, as computed by the last project_vertices().
+      const projected_points_t& get_tiling_points() const { return my_tiling_points; }
+
+      // Statistics of the last locate_tiles(), when enabled. See stats.h.
+      const locate_stats_t& get_locate_stats() const { return my_locate_stats; }
+
       // Receives points, point_reporter_t implementation.
+      // The bounds are used to pack the vertices.
+      void report_bounds(const int some_bounds[2][vertex_t::MAX_DIM], int a_dimensions_count) override;
       void report_point(const vertex_t& a_point) override;
+      void report_points(std::span<const vertex_t> some_points) override;
 
       // The locate_tiles function goes over each vertex in my_vertex_storage,
       // and finds neighboring vertices also in the list.  This determines
       // the tiles. The coordinates of the tiles are stored in my_tile_storage.
+      // The neighbors are searched as selected by set_tile_search().
       //
       // The interruptor is called periodically to provide a way of stopping
       // the computation; should return true for the computation to stop.
@@ -43,14 +93,66 @@ namespace dak::quasitiler
       // any reason.
       bool locate_tiles(interruptor_t& an_interruptor);
 
+      // Multi-threaded locate_tiles(). The vertices are split in blocks which
+      // the worker threads claim one at a time. Each block keeps its own tiles,
+      // which are appended to the tiles of the drawing in block order, so the
+      // tiles are exactly the same, in the same order, as with the
+      // single-threaded locate_tiles(). The hashed search also builds its
+      // index in parallel, and the sorted search sorts the vertices in parallel.
+      //
+      // The interruptor is only called from the calling thread. A thread count
+      // of zero or less uses all available cores.
+      bool locate_tiles(interruptor_t& an_interruptor, int a_thread_count);
+
+      // Project all the vertices to the tiling plane, so that drawing them
+      // does not need to project them again. locate_tiles() does it once the
+      // tiles are located, followed by order_vertices(). Whatever locates the
+      // tiles otherwise must do both too. The points are cleared when new
+      // bounds are reported, and are otherwise kept until projected again.
+      void project_vertices(int a_thread_count);
+
+      // Reorder the vertices as selected by set_vertex_order() and give the
+      // tiles the new index of their vertex. The projected points follow
+      // their vertex, and are projected first if they do not match them.
+      // The thread count is used to sort the vertices, like in locate_tiles().
+      void order_vertices(int a_thread_count);
+
       // Convert lattice point to 2D point.
       void lattice_to_tiling(const vertex_t& a_lattice_point, tiling_point_t& a_tiling_point) const;
       void lattice_to_orthogonal(vertex_t a_lattice_point, tiling_point_t& an_ortho_point) const;
 
+      // Convert many lattice points at once, into arrays of as many x and y,
+      // giving exactly the same points as the single-point conversions.
+      // Large inputs are split between threads. A thread count of zero or
+      // less uses all available cores.
+      void lattice_to_tiling(std::span<const vertex_t> some_lattice_points, double some_xs[], double some_ys[], int a_thread_count) const;
+      void lattice_to_orthogonal(std::span<const vertex_t> some_lattice_points, double some_xs[], double some_ys[], int a_thread_count) const;
+
+   private:
+      // The projections used by the lattice point conversions.
+      projection_t get_tiling_projection() const;
+      projection_t get_orthogonal_projection() const;
+
+      // Locate the tiles in the given sorted or hashed vertices.
+      template <class KEY>
+      bool locate_tiles(std::vector<KEY>& some_keys, interruptor_t& an_interruptor, int a_thread_count);
+
+      // Locate the tiles of the vertices from a_begin to an_end, excluded,
+      // into the given tiles, using the given functions to find the neighbor
+      // of a vertex along a coordinate and to verify if a neighbor is a vertex.
+      // Specialized for the dimension of the tiling by dispatch_dimension().
+      template <int DIM, class KEY, class STEP, class FOUND>
+      bool locate_tiles(const std::vector<KEY>& some_keys, size_t a_begin, size_t an_end, STEP&& step, FOUND&& is_found,
+                        tile_list_t some_tiles[], locate_stats_t& some_stats, interruptor_t& an_interruptor) const;
+
    public:
       std::shared_ptr<tiling_t>  my_tiling;
       vertex_list_t              my_vertex_storage;
       tile_list_t                my_tile_storage[tiling_t::MAX_TILE_COMB];
+      tile_search_t              my_tile_search = tile_search_t::hashed;
+      vertex_order_t             my_vertex_order = vertex_order_t::located;
+      projected_points_t         my_tiling_points;
+      locate_stats_t             my_locate_stats;
 
    };
 }
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_DRAWING_CACHE_H
+#define DAK_QUASITILER_DRAWING_CACHE_H
+
+#include <dak/quasitiler/drawing.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Key identifying a generated drawing: all the parameters that determine
+   // its vertices and tiles, in canonical form, and their hash.
+   //
+   // The parameters are the dimension, the two generators of the tiling
+   // plane, the offsets and the two bounds of the tiling plane. The tiling
+   // must have been initialized.
+
+   struct drawing_key_t
+   {
+      drawing_key_t() = default;
+      drawing_key_t(const tiling_t& a_tiling, const double tiling_bounds[2][tiling_t::MAX_DIM]);
+
+      std::vector<double>  parameters;
+      std::uint64_t        hash = 0;
+
+      // Name of the key, used as the file name in the disk cache.
+      std::string name() const;
+
+      bool operator==(const drawing_key_t& an_other) const = default;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Cache of generated drawings, so that going back to parameters that
+   // were already generated does not regenerate them.
+   //
+   // The memory tier keeps the most recently used drawings. The optional
+   // disk tier keeps every drawing put in the cache in its own drawing file
+   // in a directory. Drawings found on disk are put back in the memory tier.
+   //
+   // The cached drawings must not be modified. The cache can be used from
+   // multiple threads.
+
+   struct drawing_cache_t
+   {
+      // Create a cache keeping at most the given number of drawings in memory.
+      drawing_cache_t(size_t a_memory_capacity = 8) : my_memory_capacity(a_memory_capacity) { }
+
+      // Number of drawings kept in memory.
+      size_t get_memory_capacity() const;
+      void   set_memory_capacity(size_t a_memory_capacity);
+
+      // Directory of the disk tier. Empty, the default, when there is none.
+      std::filesystem::path get_disk_directory() const;
+      void                  set_disk_directory(const std::filesystem::path& a_directory);
+
+      // Find the drawing with the given key, in memory or on disk. A drawing
+      // loaded from disk is associated with the given tiling, which must be
+      // the one from which the key was made, and which is then marked as
+      // generated. Returns nullptr if not found.
+      std::shared_ptr<const drawing_t> find(const drawing_key_t& a_key, const std::shared_ptr<tiling_t>& a_tiling);
+
+      // Put a drawing in the cache, replacing any drawing with the same key.
+      // Also writes it to disk if the disk tier is used. A drawing that
+      // cannot be written is only kept in memory.
+      void insert(const drawing_key_t& a_key, const std::shared_ptr<const drawing_t>& a_drawing);
+
+      // Remove all the drawings from memory. The disk tier is kept.
+      void clear();
+
+      // Load a drawing written by write_drawing_file(). The loaded drawing is
+      // associated with the given tiling, which is then marked as generated.
+      // Returns nullptr if the file is missing, invalid or was made for
+      // another key.
+      static std::shared_ptr<drawing_t> load(const std::filesystem::path& a_file_name, const drawing_key_t& a_key, const std::shared_ptr<tiling_t>& a_tiling);
+
+   private:
+      using entry_t = std::pair<drawing_key_t, std::shared_ptr<const drawing_t>>;
+      using entries_t = std::list<entry_t>;
+
+      // Put an entry in the memory tier, as the most recent one.
+      void insert_in_memory(const drawing_key_t& a_key, const std::shared_ptr<const drawing_t>& a_drawing);
+
+      // Remove the least recently used entries until within capacity.
+      void trim_memory();
+
+      std::filesystem::path disk_file_name(const drawing_key_t& a_key) const;
+
+      mutable std::mutex                                       my_mutex;
+      size_t                                                   my_memory_capacity;
+      std::filesystem::path                                    my_disk_directory;
+      entries_t                                                my_entries;
+      std::unordered_map<std::uint64_t, entries_t::iterator>   my_entries_by_hash;
+
+      // Hashes of the keys whose file is being written.
+      std::unordered_set<std::uint64_t>                        my_writing_hashes;
+   };
+}
+
+#endif /* DAK_QUASITILER_DRAWING_CACHE_H */
@@ -0,0 +1,129 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_DRAWING_FILE_H
+#define DAK_QUASITILER_DRAWING_FILE_H
+
+#include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/packed_vertex.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Binary file format of a drawing, made to be memory-mapped.
+   //
+   // The file starts with the header, followed by the vertex table and
+   // by one tile table per tile combination. Each table starts on a
+   // multiple of SECTION_ALIGN bytes from the start of the file, so that
+   // it can be used in place once the file is mapped.
+   //
+   // The vertex table holds either the packed keys of the vertices, as
+   // 64-bit integers, or the full vertices, as vertex_t. The tile tables
+   // hold the index of the vertex of each tile, as 64-bit integers.
+   //
+   // Everything is in the byte order of the machine that wrote the file,
+   // recorded in the header. Readers refuse files of another byte order.
+
+   struct drawing_file_header_t
+   {
+      static constexpr char            MAGIC[8] = { 'Q', 'T', 'I', 'L', 'I', 'N', 'G', 0 };
+      static constexpr std::uint32_t   VERSION = 1;
+      static constexpr std::uint32_t   BYTE_ORDER_MARK = 0x01020304;
+      static constexpr std::uint64_t   SECTION_ALIGN = 64;
+
+      static constexpr int MAX_DIM = tiling_t::MAX_DIM;
+      static constexpr int MAX_TILE_COMB = tiling_t::MAX_TILE_COMB;
+
+      enum class vertex_format_t : std::int32_t
+      {
+         full = 0,
+         packed = 1,
+      };
+
+      // Position and number of elements of a table.
+      struct section_t
+      {
+         std::uint64_t offset = 0;
+         std::uint64_t count = 0;
+      };
+
+      char              magic[8] = { };
+      std::uint32_t     version = 0;
+      std::uint32_t     byte_order = 0;
+      std::uint64_t     header_size = 0;
+      std::uint64_t     file_size = 0;
+
+      // The tiling.
+      std::int32_t      dimensions_count = 0;
+      std::int32_t      tile_combinations_count = 0;
+      std::int32_t      tile_generator[MAX_TILE_COMB][2] = { };
+      std::int32_t      slope_orders[MAX_DIM] = { };
+      std::int32_t      signs[MAX_DIM] = { };
+      double            generator[MAX_DIM][MAX_DIM] = { };
+      double            offset[MAX_DIM] = { };
+
+      // The vertices and tiles.
+      vertex_format_t   vertex_format = vertex_format_t::full;
+      std::int32_t      packing_bounds[2][MAX_DIM] = { };
+      std::int32_t      reserved = 0;
+      section_t         vertices;
+      section_t         tiles[MAX_TILE_COMB];
+   };
+
+   // Write a drawing, whose tiles have been located, to a file.
+   // Returns false if the file cannot be written.
+   bool write_drawing_file(const std::filesystem::path& a_file_name, const drawing_t& a_drawing);
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // A drawing file mapped in memory.
+   //
+   // The vertices and tiles are used directly from the mapped file, without
+   // copying or parsing, through the same views as drawing_t. Multiple
+   // processes mapping the same file share its memory.
+   //
+   // Opening verifies the header and that all tables are within the file,
+   // but not the tile vertex indexes, which would require reading them all.
+
+   struct mapped_drawing_t
+   {
+      mapped_drawing_t() = default;
+      mapped_drawing_t(const mapped_drawing_t&) = delete;
+      mapped_drawing_t& operator=(const mapped_drawing_t&) = delete;
+      ~mapped_drawing_t();
+
+      // Map the file. Returns false if it cannot be mapped or is not a
+      // valid drawing file.
+      bool open(const std::filesystem::path& a_file_name);
+      void close();
+      bool is_open() const { return my_data != nullptr; }
+
+      // The tiling description.
+      const drawing_file_header_t& get_header() const { return *reinterpret_cast<const drawing_file_header_t*>(my_data); }
+      int dimensions_count() const        { return get_header().dimensions_count; }
+      int tile_combinations_count() const { return get_header().tile_combinations_count; }
+
+      // Access to the drawing data.
+      packed_vertex_view_t             get_vertex_storage() const { return my_vertices; }
+      std::span<const std::uint64_t>   get_tile_storage(int a_tile_comb) const;
+
+   private:
+      bool verify() const;
+
+      const std::uint8_t*     my_data = nullptr;
+      std::uint64_t           my_size = 0;
+      packed_vertex_view_t    my_vertices;
+
+   #ifdef _WIN32
+      void*                   my_file = nullptr;
+      void*                   my_mapping = nullptr;
+   #endif
+   };
+}
+
+#endif /* DAK_QUASITILER_DRAWING_FILE_H */
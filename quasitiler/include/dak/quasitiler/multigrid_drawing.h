@@ -0,0 +1,67 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_MULTIGRID_DRAWING_H
+#define DAK_QUASITILER_MULTIGRID_DRAWING_H
+
+#include <dak/quasitiler/drawing.h>
+
+#include <memory>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Generate the vertices and the tiles of a drawing with de Bruijn's
+   // multigrid method instead of scanning the lattice.
+   //
+   // Each lattice coordinate defines a family of parallel grid lines in the
+   // tiling plane, where that coordinate of the plane point offset +
+   // x * generator[0] + y * generator[1] is a half-integer. Each intersection
+   // of two lines is a tile: rounding the other coordinates at the
+   // intersection gives its corners. So the work is proportional to the
+   // number of tiles, without any window test.
+   //
+   // The tiles are those intersecting the tiling bounds, the vertices are
+   // the corners of those tiles. They fill the vertex and tile storage of
+   // the drawing as tiling_t::generate() followed by drawing_t::locate_tiles()
+   // would, so locate_tiles() must not be called afterward. The vertices
+   // are then projected and ordered as the drawing selects, as locate_tiles()
+   // does.
+   //
+   // When three grid lines meet, or nearly so, the tiling is singular and
+   // the tiles at that point are ambiguous. The drawing is then generated
+   // by the scan of the tiling instead.
+
+   struct multigrid_drawing_t
+   {
+      // Constructor, associate the engine with the given tiling.
+      multigrid_drawing_t(std::shared_ptr<tiling_t> a_tiling) : my_tiling(a_tiling) { }
+
+      std::shared_ptr<tiling_t> get_tiling() const { return my_tiling; }
+
+      // Generate the vertices and the tiles intersecting the tiling bounds
+      // into the drawing, which must be associated with the same tiling.
+      // Its previous content is replaced.
+      //
+      // The interruptor is called periodically to provide a way of stopping
+      // the computation; should return true for the computation to stop.
+      //
+      // generate() returns false if it cannot finish the computation for
+      // any reason.
+      bool generate(double tiling_bounds[2][tiling_t::MAX_DIM], drawing_t& a_drawing, interruptor_t& an_interruptor);
+
+      // Verify if the last generate() had to fall back to the scan of the tiling.
+      bool used_fallback() const { return my_used_fallback; }
+
+   private:
+      // Intersect the grid lines. Returns false when interrupted or when the
+      // drawing must be generated by the scan, which sets my_used_fallback.
+      bool intersect_grids(double tiling_bounds[2][tiling_t::MAX_DIM], drawing_t& a_drawing, interruptor_t& an_interruptor);
+
+      std::shared_ptr<tiling_t>  my_tiling;
+      bool                       my_used_fallback = false;
+   };
+}
+
+#endif /* DAK_QUASITILER_MULTIGRID_DRAWING_H */
@@ -0,0 +1,206 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_PACKED_VERTEX_H
+#define DAK_QUASITILER_PACKED_VERTEX_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Packing of a vertex in a single 64-bit key.
+   //
+   // Each active coordinate is kept relative to a base, in a lane with just
+   // enough bits for its range. The first coordinate goes in the most
+   // significant lane, so keys compare in the same order as vertex_t.
+   //
+   // The lanes have one spare value on each side of the range, so that
+   // stepping a packed vertex by one along a coordinate never spills
+   // into the neighboring lane.
+
+   struct vertex_packing_t
+   {
+      using key_t = uint64_t;
+
+      static constexpr int MAX_DIM = vertex_t::MAX_DIM;
+
+      // Packing that does not fit anything.
+      vertex_packing_t() = default;
+
+      // Packing for the vertices within the given inclusive bounds.
+      vertex_packing_t(const int some_bounds[2][MAX_DIM], int a_dimensions_count);
+
+      // Verify if the bounds fit in a key and if a vertex fits in the bounds.
+      bool fits() const { return my_dimensions_count > 0 && my_key_bits <= 64; }
+      bool contains(const vertex_t& a_vertex) const;
+
+      // Convert between vertices and keys.
+      key_t    pack(const vertex_t& a_vertex) const;
+      vertex_t unpack(key_t a_key) const;
+
+      // Difference between the keys of two vertices one unit apart along the coordinate.
+      key_t unit(int a_coord) const { return key_t(1) << my_shifts[a_coord]; }
+
+      int dimensions_count() const  { return my_dimensions_count; }
+      int key_bits() const          { return my_key_bits; }
+
+      // The lane of the coordinate: the coordinate is its base plus the
+      // bits of the key under its mask once shifted down.
+      int   lane_base(int a_coord) const  { return my_bases[a_coord]; }
+      int   lane_shift(int a_coord) const { return my_shifts[a_coord]; }
+      key_t lane_mask(int a_coord) const  { return my_masks[a_coord]; }
+
+      // The inclusive bounds given to the constructor.
+      void get_bounds(int some_bounds[2][MAX_DIM]) const;
+
+   private:
+      int my_dimensions_count = 0;
+      int my_key_bits = 0;
+      int my_bounds[2][MAX_DIM] = { };
+      int my_bases[MAX_DIM] = { };
+      int my_shifts[MAX_DIM] = { };
+      key_t my_masks[MAX_DIM] = { };
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Iterates over the unpacked vertices of a list or view of packed vertices.
+   //
+   // The vertices are unpacked when read, so the iterator only moves forward,
+   // but the distance between two iterators is known without walking.
+
+   struct packed_vertex_view_t;
+
+   template <class LIST>
+   struct packed_vertex_iterator_t
+   {
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = vertex_t;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = vertex_t;
+
+      const LIST* list = nullptr;
+      size_t index = 0;
+
+      vertex_t operator*() const { return (*list)[index]; }
+      packed_vertex_iterator_t& operator++() { ++index; return *this; }
+      packed_vertex_iterator_t operator++(int) { packed_vertex_iterator_t old = *this; ++index; return old; }
+      bool operator==(const packed_vertex_iterator_t& an_other) const { return index == an_other.index; }
+      difference_type operator-(const packed_vertex_iterator_t& an_other) const { return difference_type(index) - difference_type(an_other.index); }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // List of vertices kept as packed keys.
+   //
+   // Vertices that do not fit the packing switch the whole list to full
+   // vertices, so any vertex can be added. Access by index unpacks.
+
+   struct packed_vertex_list_t
+   {
+      using key_t = vertex_packing_t::key_t;
+
+      // Iterates over the unpacked vertices.
+      using const_iterator = packed_vertex_iterator_t<packed_vertex_list_t>;
+
+      // Set the packing used to keep the vertices. Vertices already in
+      // the list are repacked.
+      void set_packing(const vertex_packing_t& a_packing);
+      const vertex_packing_t& get_packing() const { return my_packing; }
+
+      // Add vertices.
+      void push_back(const vertex_t& a_vertex);
+      void append(std::span<const vertex_t> some_vertices);
+
+      // Access the vertices.
+      vertex_t operator[](size_t an_index) const
+      {
+         return my_is_packed ? my_packing.unpack(my_keys[an_index]) : my_vertices[an_index];
+      }
+
+      size_t size() const  { return my_is_packed ? my_keys.size() : my_vertices.size(); }
+      bool   empty() const { return size() == 0; }
+      void   clear()       { my_keys.clear(); my_vertices.clear(); }
+
+      const_iterator begin() const { return const_iterator{ this, 0 }; }
+      const_iterator end() const   { return const_iterator{ this, size() }; }
+
+      // Access the storage: the keys when packed, the full vertices otherwise.
+      bool                          is_packed() const { return my_is_packed; }
+      std::vector<key_t>&           keys()            { return my_keys; }
+      const std::vector<key_t>&     keys() const      { return my_keys; }
+      std::vector<vertex_t>&        vertices()        { return my_vertices; }
+      const std::vector<vertex_t>&  vertices() const  { return my_vertices; }
+
+      // Read-only view of the list.
+      packed_vertex_view_t view() const;
+
+   private:
+      void unpack_all();
+
+      vertex_packing_t        my_packing;
+      bool                    my_is_packed = false;
+      std::vector<key_t>      my_keys;
+      std::vector<vertex_t>   my_vertices;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Read-only view of vertices kept elsewhere, either as packed keys or as
+   // full vertices, with the same access as packed_vertex_list_t.
+
+   struct packed_vertex_view_t
+   {
+      using key_t = vertex_packing_t::key_t;
+      using const_iterator = packed_vertex_iterator_t<packed_vertex_view_t>;
+
+      // Empty view.
+      packed_vertex_view_t() = default;
+
+      // View of packed keys or of full vertices.
+      packed_vertex_view_t(const vertex_packing_t& a_packing, std::span<const key_t> some_keys)
+         : my_packing(a_packing), my_is_packed(true), my_keys(some_keys) { }
+      packed_vertex_view_t(std::span<const vertex_t> some_vertices)
+         : my_vertices(some_vertices) { }
+
+      const vertex_packing_t& get_packing() const { return my_packing; }
+
+      // Access the vertices.
+      vertex_t operator[](size_t an_index) const
+      {
+         return my_is_packed ? my_packing.unpack(my_keys[an_index]) : my_vertices[an_index];
+      }
+
+      size_t size() const  { return my_is_packed ? my_keys.size() : my_vertices.size(); }
+      bool   empty() const { return size() == 0; }
+
+      const_iterator begin() const { return const_iterator{ this, 0 }; }
+      const_iterator end() const   { return const_iterator{ this, size() }; }
+
+      // Access the storage: the keys when packed, the full vertices otherwise.
+      bool                       is_packed() const { return my_is_packed; }
+      std::span<const key_t>     keys() const      { return my_keys; }
+      std::span<const vertex_t>  vertices() const  { return my_vertices; }
+
+   private:
+      vertex_packing_t           my_packing;
+      bool                       my_is_packed = false;
+      std::span<const key_t>     my_keys;
+      std::span<const vertex_t>  my_vertices;
+   };
+
+   inline packed_vertex_view_t packed_vertex_list_t::view() const
+   {
+      return my_is_packed ? packed_vertex_view_t(my_packing, my_keys) : packed_vertex_view_t(my_vertices);
+   }
+}
+
+#endif /* DAK_QUASITILER_PACKED_VERTEX_H */
@@ -0,0 +1,170 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_PARALLEL_H
+#define DAK_QUASITILER_PARALLEL_H
+
+#include <dak/quasitiler/interruptor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Worker threads shared by the multi-threaded algorithms.
+
+   // The number of threads to use for the given count: all available cores
+   // for a count of zero or less.
+   inline int get_thread_count(int a_thread_count)
+   {
+      if (a_thread_count <= 0)
+         return std::max(1, (int)std::thread::hardware_concurrency());
+      return a_thread_count;
+   }
+
+   // Interruptor shared by the worker threads.
+   struct stop_flag_t : interruptor_t
+   {
+      std::atomic<bool> is_stopped = false;
+
+      bool interrupted() override
+      {
+         return is_stopped.load(std::memory_order_relaxed);
+      }
+   };
+
+   // Call the function with each thread index on its own thread, index
+   // zero on the calling thread. Once all are done, rethrow the first
+   // exception thrown by any of them.
+   template <class FUNCTION>
+   void run_threads(int a_thread_count, FUNCTION&& a_function)
+   {
+      std::exception_ptr error;
+      std::mutex error_mutex;
+      auto run = [&](int a_thread_index)
+      {
+         try
+         {
+            a_function(a_thread_index);
+         }
+         catch (...)
+         {
+            std::lock_guard lock(error_mutex);
+            if (!error)
+               error = std::current_exception();
+         }
+      };
+
+      std::vector<std::thread> workers;
+      for (int thread_index = 1; thread_index < a_thread_count; ++thread_index)
+         workers.emplace_back(run, thread_index);
+
+      run(0);
+
+      for (std::thread& worker : workers)
+         worker.join();
+
+      if (error)
+         std::rethrow_exception(error);
+   }
+
+   // Do the items on the threads, each thread claiming the next item until
+   // there are none left, and consume the done items in order.
+   //
+   // do_item(thread_index, item, stop) does an item and returns false if it
+   // was stopped before finishing it. consume_item(item) is only called from
+   // the calling thread, after each of the items it does and once all the
+   // threads are done. The calling thread is also the only one calling the
+   // interruptor, and stops all threads when interrupted or when any thread
+   // throws.
+   //
+   // At most the given count of items are claimed past the last consumed one,
+   // so that the results of that many items at most are kept at once: the
+   // other threads wait and the calling thread consumes items until then.
+   //
+   // Returns false if stopped, like the single-threaded algorithms, which
+   // give the interruptor a last chance to stop once done.
+   template <class DO_ITEM, class CONSUME_ITEM>
+   bool run_ordered(int a_thread_count, size_t an_item_count, size_t a_max_pending_count, interruptor_t& an_interruptor, DO_ITEM&& do_item, CONSUME_ITEM&& consume_item)
+   {
+      std::vector<std::atomic<bool>> is_done(an_item_count);
+      std::atomic<size_t> next_item = 0;
+      std::atomic<size_t> next_consumed = 0;
+      stop_flag_t stop;
+
+      auto consume_done_items = [&]()
+      {
+         for (size_t item = next_consumed.load(std::memory_order_relaxed); item < an_item_count && is_done[item].load(std::memory_order_acquire); ++item)
+         {
+            consume_item(item);
+            next_consumed.store(item + 1, std::memory_order_release);
+         }
+         if (an_interruptor.interrupted())
+            stop.is_stopped = true;
+      };
+
+      // The item claimed is never consumed yet, so it is at or past the next consumed one.
+      auto wait_for_pending = [&](int a_thread_index, size_t an_item)
+      {
+         while (an_item - next_consumed.load(std::memory_order_acquire) >= a_max_pending_count && !stop.interrupted())
+         {
+            if (a_thread_index == 0)
+               consume_done_items();
+            std::this_thread::yield();
+         }
+         return !stop.interrupted();
+      };
+
+      run_threads(a_thread_count, [&](int a_thread_index)
+      {
+         try
+         {
+            for (size_t item = next_item++; item < an_item_count && wait_for_pending(a_thread_index, item); item = next_item++)
+            {
+               if (!do_item(a_thread_index, item, stop))
+                  break;
+               is_done[item].store(true, std::memory_order_release);
+
+               if (a_thread_index == 0)
+                  consume_done_items();
+            }
+
+            // The other threads may be waiting for items to be consumed.
+            if (a_thread_index == 0)
+               wait_for_pending(a_thread_index, an_item_count);
+         }
+         catch (...)
+         {
+            stop.is_stopped = true;
+            throw;
+         }
+      });
+
+      if (stop.interrupted())
+         return false;
+
+      consume_done_items();
+
+      return !stop.interrupted();
+   }
+
+   // Do the items on the threads and consume them in order, without limiting
+   // how many done items are kept until they are consumed.
+   template <class DO_ITEM, class CONSUME_ITEM>
+   bool run_ordered(int a_thread_count, size_t an_item_count, interruptor_t& an_interruptor, DO_ITEM&& do_item, CONSUME_ITEM&& consume_item)
+   {
+      return run_ordered(a_thread_count, an_item_count, SIZE_MAX, an_interruptor,
+                         std::forward<DO_ITEM>(do_item), std::forward<CONSUME_ITEM>(consume_item));
+   }
+}
+
+#endif /* DAK_QUASITILER_PARALLEL_H */
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_PNG_WRITER_H
+#define DAK_QUASITILER_PNG_WRITER_H
+
+#include <dak/quasitiler/buffered_writer.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Write an RGB PNG image row by row, so that the image never needs to be
+   // in memory all at once.
+   //
+   // Each row is filtered with the PNG sub filter, which turns runs of the
+   // same color into runs of zeros, then compressed as one deflate block
+   // with the fixed Huffman codes, only looking for runs of the same byte.
+   // This compresses the large flat areas of a tiling well while costing
+   // little more than copying the rows. The file is written on a
+   // background thread.
+
+   struct png_writer_t
+   {
+      png_writer_t() = default;
+      png_writer_t(const png_writer_t&) = delete;
+      png_writer_t& operator=(const png_writer_t&) = delete;
+      ~png_writer_t();
+
+      // Create the file and write the image header.
+      // Returns false if the file cannot be created.
+      bool open(const std::filesystem::path& a_file_name, int a_width, int a_height);
+
+      // Write the next row, as width RGB pixels of 3 bytes each.
+      void write_row(const std::uint8_t* some_pixels);
+
+      // Finish the image and close the file. Returns false if the file could
+      // not be written or not all the rows were written.
+      bool close();
+
+      bool is_open() const { return my_writer.is_open(); }
+
+   private:
+      // Compressed stream. Writing a run of zero bytes ends the pending run.
+      void write_run(std::uint8_t a_byte, int a_count);
+      void write_literal(std::uint8_t a_byte);
+      void write_match(int a_length);
+      void write_bits(std::uint32_t some_bits, int a_bit_count);
+
+      // PNG chunks. The compressed data is written as IDAT chunks.
+      void write_chunk(const char a_type[4], const std::uint8_t* some_data, size_t a_size);
+      void flush_compressed(bool is_last);
+
+      buffered_writer_t          my_writer;
+      int                        my_width = 0;
+      int                        my_height = 0;
+      int                        my_rows_count = 0;
+
+      // Deflate state.
+      std::vector<std::uint8_t>  my_row;
+      std::vector<std::uint8_t>  my_compressed;
+      std::uint32_t              my_bits = 0;
+      int                        my_bit_count = 0;
+      bool                       my_has_previous = false;
+      std::uint8_t               my_previous = 0;
+      int                        my_run_count = 0;
+      std::uint32_t              my_adler_a = 1;
+      std::uint32_t              my_adler_b = 0;
+   };
+}
+
+#endif /* DAK_QUASITILER_PNG_WRITER_H */
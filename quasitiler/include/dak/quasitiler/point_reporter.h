@@ -4,6 +4,8 @@
 #define DAK_QUASITILER_POINT_REPORTER_H
 
 #include <compare>
+#include <cstddef>
+#include <span>
 
 
 namespace dak::quasitiler
@@ -31,6 +33,55 @@ namespace dak::quasitiler
       virtual ~point_reporter_t() = default;
 
       virtual void report_point(const vertex_t& a_point) = 0;
+
+      // Receives the bounds, inclusive, of all the points about to be
+      // reported, before any point is reported. By default, ignored.
+      virtual void report_bounds(const int /*some_bounds*/[2][vertex_t::MAX_DIM], int /*a_dimensions_count*/) { }
+
+      // Receives many points at once. By default, reports them one by one.
+      virtual void report_points(std::span<const vertex_t> some_points)
+      {
+         for (const vertex_t& point : some_points)
+            report_point(point);
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Fixed-size staging buffer that passes points to a reporter in batches,
+   // to avoid a virtual call for every point.
+   //
+   // flush() must be called once all the points have been reported.
+
+   struct point_batch_t
+   {
+      static constexpr size_t BATCH_SIZE = 256;
+
+      point_batch_t(point_reporter_t& a_reporter) : my_reporter(a_reporter) { }
+
+      void report_bounds(const int some_bounds[2][vertex_t::MAX_DIM], int a_dimensions_count)
+      {
+         my_reporter.report_bounds(some_bounds, a_dimensions_count);
+      }
+
+      void report_point(const vertex_t& a_point)
+      {
+         my_points[my_count++] = a_point;
+         if (my_count == BATCH_SIZE)
+            flush();
+      }
+
+      void flush()
+      {
+         if (my_count > 0)
+            my_reporter.report_points(std::span<const vertex_t>(my_points, my_count));
+         my_count = 0;
+      }
+
+   private:
+      point_reporter_t& my_reporter;
+      size_t            my_count = 0;
+      vertex_t          my_points[BATCH_SIZE];
    };
 }
 
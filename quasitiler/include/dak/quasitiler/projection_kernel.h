@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_PROJECTION_KERNEL_H
+#define DAK_QUASITILER_PROJECTION_KERNEL_H
+
+#include <dak/quasitiler/packed_vertex.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Linear projection of lattice points to a plane. Each coordinate of a
+   // point, less its offset, moves the projected point along its generator.
+
+   struct projection_t
+   {
+      static constexpr int MAX_DIM = vertex_t::MAX_DIM;
+
+      double   x_generator[MAX_DIM] = { };
+      double   y_generator[MAX_DIM] = { };
+      double   offsets[MAX_DIM] = { };
+      int      dimensions_count = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Projected points, with all the x and all the y in separate arrays, so
+   // that they are written and read a vector register at a time.
+
+   struct projected_points_t
+   {
+      std::vector<double> xs;
+      std::vector<double> ys;
+
+      size_t size() const  { return xs.size(); }
+      bool   empty() const { return xs.empty(); }
+
+      void resize(size_t a_count) { xs.resize(a_count); ys.resize(a_count); }
+      void clear()                { xs.clear(); ys.clear(); }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vectorized projection of lattice points.
+   //
+   // All kernels do the subtractions, multiplications and additions
+   // separately and in the same order as the scalar code, so they give
+   // exactly the same positions.
+
+   struct projection_kernel_t
+   {
+      // Name of the instruction set used.
+      const char* name;
+
+      // Project the given number of points into the x and y arrays.
+      void (*project)(const projection_t& a_projection, const vertex_t some_points[], size_t a_count, double some_xs[], double some_ys[]);
+
+      // Project the given number of packed points, without unpacking them.
+      void (*project_keys)(const projection_t& a_projection, const vertex_packing_t& a_packing, const vertex_packing_t::key_t some_keys[],
+                           size_t a_count, double some_xs[], double some_ys[]);
+   };
+
+   // The kernel for the best instruction set supported by the running CPU.
+   //
+   // When given a dimension count, the kernel is specialized for it and must
+   // only be used with projections of that dimension. Otherwise, or for
+   // dimensions without a specialization, it works for any dimension.
+   const projection_kernel_t& get_projection_kernel(int a_dimensions_count = 0);
+
+   // The kernels for specific instruction sets. The SIMD ones return
+   // nullptr when the running CPU does not support them.
+   const projection_kernel_t& get_scalar_projection_kernel(int a_dimensions_count = 0);
+   const projection_kernel_t* get_avx2_projection_kernel(int a_dimensions_count = 0);
+}
+
+#endif /* DAK_QUASITILER_PROJECTION_KERNEL_H */
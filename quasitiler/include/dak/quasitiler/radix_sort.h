@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_RADIX_SORT_H
+#define DAK_QUASITILER_RADIX_SORT_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Least-significant-digit radix sorts of vertices, giving the same order
+   // as std::sort() but only looking at the bits that can differ.
+   //
+   // Packed keys are sorted on their used bits only. Full vertices are sorted
+   // on their active coordinates, each only on the bits of its range among
+   // the vertices. Passes in which all the values have the same digit are
+   // skipped.
+   //
+   // Large inputs are sorted in parallel: each thread counts and then moves
+   // its own slice, so the order does not depend on the thread count. A
+   // thread count of zero or less uses all available cores.
+
+   // Sort the keys, of which only the lowest bits are used.
+   void radix_sort(std::vector<uint64_t>& some_keys, int a_key_bits, int a_thread_count);
+
+   // Sort the vertices, of which only the first coordinates are used, the
+   // others being the same for all vertices.
+   void radix_sort(std::vector<vertex_t>& some_vertices, int a_dimensions_count, int a_thread_count);
+}
+
+#endif /* DAK_QUASITILER_RADIX_SORT_H */
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_RASTERIZER_H
+#define DAK_QUASITILER_RASTERIZER_H
+
+#include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/tile_colors.h>
+
+#include <cstdint>
+#include <filesystem>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // How the tiles are drawn in a raster image.
+
+   struct raster_style_t
+   {
+      // Default style: the default tile colors, thin grey edges, antialiased.
+      raster_style_t() { get_default_tile_group_colors(tile_group_colors); }
+
+      // Size of the unit tile edge, in pixels.
+      double               tile_size = 20.;
+
+      // Edges of the tiles, in pixels. No edges are drawn when the thickness is zero.
+      double               edge_thickness = 1.;
+      std::uint32_t        edge_color = 0x808080;
+      double               edge_opacity = 1.;
+
+      // Color where there are no tiles.
+      std::uint32_t        background_color = 0xFFFFFF;
+
+      // Colors of the tile groups, interpolated for each tile combination.
+      tile_group_colors_t  tile_group_colors;
+
+      // Antialias the tiles and edges by sampling each pixel at multiple heights
+      // and computing the exact horizontal coverage.
+      bool                 antialias = true;
+
+      // Height of the bands of the image drawn at once, in pixels.
+      int                  band_height = 64;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Draw the located tiles of a drawing in a PNG image covering the tiling
+   // bounds, with the tiling origin toward the top-left of the image.
+   //
+   // The image is drawn in horizontal bands, each thread drawing its own band
+   // with the tiles binned to it beforehand. The bands are written in order
+   // as they are done, so the whole image is never in memory.
+   //
+   // A thread count of zero uses all cores. Returns false if the file cannot
+   // be written.
+
+   bool write_png_file(const std::filesystem::path& a_file_name, const drawing_t& a_drawing,
+                       const double tiling_bounds[2][tiling_t::MAX_DIM], const raster_style_t& a_style = raster_style_t(),
+                       int a_thread_count = 1);
+}
+
+#endif /* DAK_QUASITILER_RASTERIZER_H */
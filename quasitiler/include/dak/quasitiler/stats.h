@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_STATS_H
+#define DAK_QUASITILER_STATS_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Statistics of the hot paths of the tiling generation and of the tile
+   // location, to see where the time goes.
+   //
+   // They are only recorded when the library is built with
+   // DAK_QUASITILER_STATS defined, which the QUASITILER_STATS CMake option
+   // does. Otherwise the code recording them is compiled out and they stay
+   // at zero.
+
+#ifdef DAK_QUASITILER_STATS
+   static constexpr bool STATS_ENABLED = true;
+#else
+   static constexpr bool STATS_ENABLED = false;
+#endif
+
+   // Statistics of tiling_t::init() and tiling_t::generate().
+   struct generate_stats_t
+   {
+      static constexpr int MAX_CRITERIA = vertex_t::MAX_DIM * (vertex_t::MAX_DIM - 1) * (vertex_t::MAX_DIM - 2) / 6;
+
+      // Wall time of each phase, in seconds.
+      double         init_seconds = 0.;
+      double         generate_seconds = 0.;
+
+      // Points of the tiling plane parametrization visited by the scan, and
+      // those that passed the preliminary clipping to the tiling bounds.
+      std::uint64_t  plane_points = 0;
+      std::uint64_t  clipped_plane_points = 0;
+
+      // Lattice points tested against the cylinder and accepted ones.
+      std::uint64_t  candidates = 0;
+      std::uint64_t  accepted = 0;
+
+      // Candidates accepted inside the inner ball of the window, rejected
+      // outside its outer ball, and the ones tested against the criteria:
+      // those in between the balls, or all of them at the dimensions that
+      // use the running values of the criteria instead of the balls. Of
+      // those, the ones that needed the exact test: all the ones between
+      // the balls, or the ones too close to a face for the running values.
+      std::uint64_t  inner_accepts = 0;
+      std::uint64_t  outer_rejects = 0;
+      std::uint64_t  criteria_tests = 0;
+      std::uint64_t  exact_tests = 0;
+
+      // Candidates rejected by the criteria, by the first criterion that
+      // rejected them, in the order the tiling checks its criteria.
+      int            criteria_count = 0;
+      std::uint64_t  criterion_rejects[MAX_CRITERIA] = { };
+      std::uint64_t  criteria_rejects = 0;
+
+      generate_stats_t& operator+=(const generate_stats_t& an_other);
+   };
+
+   // Statistics of drawing_t::locate_tiles().
+   struct locate_stats_t
+   {
+      // Wall time of each phase, in seconds: indexing or sorting the vertices,
+      // then searching the neighbors.
+      double         index_seconds = 0.;
+      double         search_seconds = 0.;
+
+      // Vertices visited, neighbors looked up and tiles found.
+      std::uint64_t  vertices = 0;
+      std::uint64_t  neighbor_lookups = 0;
+      std::uint64_t  neighbors_found = 0;
+      std::uint64_t  tiles = 0;
+
+      // Comparisons done by the binary searches of the sorted tile search.
+      std::uint64_t  binary_search_probes = 0;
+
+      locate_stats_t& operator+=(const locate_stats_t& an_other);
+   };
+
+   // Describe the statistics in text, one item per line.
+   std::string to_string(const generate_stats_t& some_stats);
+   std::string to_string(const locate_stats_t& some_stats);
+
+   // Measure the wall time of a phase, when the statistics are enabled.
+   struct stats_timer_t
+   {
+      stats_timer_t(double& some_seconds) : my_seconds(some_seconds)
+      {
+         if constexpr (STATS_ENABLED)
+            my_start = std::chrono::steady_clock::now();
+      }
+
+      ~stats_timer_t()
+      {
+         if constexpr (STATS_ENABLED)
+            my_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - my_start).count();
+      }
+
+   private:
+      double&                                   my_seconds;
+      std::chrono::steady_clock::time_point     my_start;
+   };
+}
+
+#endif /* DAK_QUASITILER_STATS_H */
@@ -0,0 +1,130 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_SUBSTITUTION_DRAWING_H
+#define DAK_QUASITILER_SUBSTITUTION_DRAWING_H
+
+#include <dak/quasitiler/drawing.h>
+
+#include <memory>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Generate the vertices and the tiles of a drawing by inflating a coarser
+   // drawing of the same tiling instead of scanning the whole lattice.
+   //
+   // When the generators are symmetric, rotating the tiling plane by pi / n
+   // permutes the projected lattice generators, up to their signs. Adding
+   // the permutation and its inverse to the identity gives an integer matrix
+   // M that scales the tiling plane by 1 + 2 cos(pi / n) and, for the
+   // dimensions 3 to 5, maps the window into itself. The vertices of the
+   // tiling with offset M^-1 offset, multiplied by M, are then vertices of
+   // the tiling: this is the inflation of the Penrose tilings in dimension 5
+   // and of the Ammann-Beenker tilings in dimension 4.
+   //
+   // The drawing is generated from a small scan, inflated level by level.
+   // Each inflated coarse tile contains the same few candidate fine vertices
+   // relative to its inflated base, computed once per tile combination.
+   // Only those candidates are tested against the window, mostly with the
+   // ball around it, and each is owned by a single coarse tile, so the work
+   // is proportional to the number of vertices, without any duplicate.
+   //
+   // The vertices are those within the tiling bounds, as tiling_t::generate()
+   // reports, and the tiles are located among them as drawing_t::locate_tiles()
+   // does, testing the neighbors of each vertex against the window instead of
+   // looking them up, so locate_tiles() must not be called afterward. The
+   // vertices are then projected and ordered as the drawing selects, as
+   // locate_tiles() does.
+   //
+   // When the tiling has no such inflation, the drawing is generated by the
+   // scan of the tiling instead.
+
+   struct substitution_drawing_t
+   {
+      // Constructor, associate the engine with the given tiling.
+      substitution_drawing_t(std::shared_ptr<tiling_t> a_tiling) : my_tiling(a_tiling) { }
+
+      std::shared_ptr<tiling_t> get_tiling() const { return my_tiling; }
+
+      // Generate the vertices within the tiling bounds and their tiles
+      // into the drawing, which must be associated with the same tiling.
+      // Its previous content is replaced.
+      //
+      // The interruptor is called periodically to provide a way of stopping
+      // the computation; should return true for the computation to stop.
+      //
+      // generate() returns false if it cannot finish the computation for
+      // any reason.
+      bool generate(double tiling_bounds[2][tiling_t::MAX_DIM], drawing_t& a_drawing, interruptor_t& an_interruptor);
+
+      // Verify if the last generate() had to fall back to the scan of the tiling.
+      bool used_fallback() const { return my_used_fallback; }
+
+   private:
+      static constexpr int MAX_DIM = tiling_t::MAX_DIM;
+      static constexpr int TARGET_DIM = tiling_t::TARGET_DIM;
+      static constexpr int WINDOW_DIM = tiling_t::WINDOW_DIM;
+
+      // A possible fine vertex relative to the inflated base of a coarse tile,
+      // with its projections to the tiling plane and the orthogonal space.
+      // It is certain when it is in the window for all the tiles.
+      struct candidate_t
+      {
+         vertex_t step;
+         double   plane[TARGET_DIM] = { };
+         double   window[WINDOW_DIM] = { };
+         bool     is_certain = false;
+      };
+
+      // A level of the inflation: the region of the plane to cover and
+      // the tiling with the offset of that level.
+      struct level_t
+      {
+         double                     region[2][TARGET_DIM];
+         std::shared_ptr<tiling_t>  tiling;
+      };
+
+      // Find the inflation matrix of the tiling and the candidates of each
+      // tile combination. Returns false when the tiling has none.
+      bool find_inflation();
+
+      // Compute the candidates of each tile combination. Returns false
+      // when there are too many lattice points to search for them.
+      bool find_candidates();
+
+      // Add the coarser levels covering the region of the last level, as
+      // long as they are much smaller and their tilings can be initialized.
+      void add_levels(std::vector<level_t>& some_levels) const;
+
+      // Fill the fine drawing with the vertices within the region of the
+      // inflated coarse drawing and of the inflated coarse tiles.
+      bool inflate(const drawing_t& a_coarse, const double a_region[2][TARGET_DIM], drawing_t& a_fine, interruptor_t& an_interruptor) const;
+
+      // Declare the bounds of the lattice points of the drawing tiling within the region.
+      void report_region(const double a_region[2][TARGET_DIM], drawing_t& a_drawing) const;
+
+      std::shared_ptr<tiling_t>  my_tiling;
+      bool                       my_used_fallback = false;
+
+      // The generators of the plane for which the inflation was found.
+      int                        my_inflated_dimensions_count = 0;
+      double                     my_inflated_generators[TARGET_DIM][MAX_DIM] = { };
+      bool                       my_has_inflation = false;
+
+      // The inflation matrix and how much it scales the plane.
+      int                        my_inflation[MAX_DIM][MAX_DIM] = { };
+      double                     my_scale = 1.;
+
+      // The inflation in the orthogonal space, in the orthogonal generators.
+      // When it shrinks the window, the inflated vertices need no test.
+      double                     my_window_inflation[WINDOW_DIM][WINDOW_DIM] = { };
+      bool                       my_is_contracting = false;
+
+      std::vector<candidate_t>   my_candidates[tiling_t::MAX_TILE_COMB];
+   };
+}
+
+#endif /* DAK_QUASITILER_SUBSTITUTION_DRAWING_H */
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_SVG_WRITER_H
+#define DAK_QUASITILER_SVG_WRITER_H
+
+#include <dak/quasitiler/buffered_writer.h>
+#include <dak/quasitiler/chunked_drawing.h>
+#include <dak/quasitiler/tile_colors.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // How the tiles are drawn in an SVG file.
+
+   struct svg_style_t
+   {
+      // Default style: thin black edges and the default tile colors.
+      svg_style_t() { get_default_tile_group_colors(tile_group_colors); }
+
+      // Size of the unit tile edge, in SVG units.
+      double               tile_size = 20.;
+
+      // Number of decimals of the coordinates.
+      int                  decimals = 2;
+
+      // Edges of the tiles. No edges are drawn when the thickness is zero.
+      double               edge_thickness = 1.;
+      std::uint32_t        edge_color = 0x000000;
+
+      // Colors of the tile groups, interpolated for each tile combination.
+      tile_group_colors_t  tile_group_colors;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Write the tiles of a tiling in an SVG file as they are located.
+   //
+   // The style of each tile combination is written once in the header, as
+   // a class. The tiles of each drawing given to the writer are written as
+   // one path per tile combination, each tile being a sub-path, so that
+   // writing a tile only formats its vertex.
+   //
+   // As a chunk reporter, the writer receives the tiles of a chunked drawing
+   // one chunk at a time, so that the memory used stays flat however many
+   // tiles are written. The file itself is written on a background thread.
+
+   struct svg_writer_t : chunk_reporter_t
+   {
+      // Constructor, associate the writer with the given tiling, which must
+      // have been initialized.
+      svg_writer_t(std::shared_ptr<tiling_t> a_tiling, const svg_style_t& a_style = svg_style_t());
+      ~svg_writer_t();
+
+      // Create the file and write its header. The tiling bounds become
+      // the visible area. Returns false if the file cannot be created.
+      bool open(const std::filesystem::path& a_file_name, const double tiling_bounds[2][tiling_t::MAX_DIM]);
+
+      // Write the footer and close the file.
+      // Returns false if any of the file could not be written.
+      bool close();
+
+      // Write the located tiles of a drawing of the tiling.
+      void write_tiles(const drawing_t& a_drawing);
+
+      // Receives chunks, chunk_reporter_t implementation.
+      void report_chunk(const drawing_t& a_chunk) override { write_tiles(a_chunk); }
+
+   private:
+      // Append a coordinate, scaled by the tile size.
+      void append_coord(std::string& a_buffer, double a_value) const;
+
+      std::shared_ptr<tiling_t>  my_tiling;
+      svg_style_t                my_style;
+      buffered_writer_t          my_writer;
+
+      // The relative moves around the tile of each combination, formatted
+      // once since they are the same for all the tiles of a combination.
+      std::string                my_tile_moves[tiling_t::MAX_TILE_COMB];
+   };
+
+   // Write all the located tiles of a drawing in an SVG file.
+   // Returns false if the file cannot be written.
+   bool write_svg_file(const std::filesystem::path& a_file_name, const drawing_t& a_drawing,
+                       const double tiling_bounds[2][tiling_t::MAX_DIM], const svg_style_t& a_style = svg_style_t());
+}
+
+#endif /* DAK_QUASITILER_SVG_WRITER_H */
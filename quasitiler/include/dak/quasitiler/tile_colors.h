@@ -0,0 +1,39 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_TILE_COLORS_H
+#define DAK_QUASITILER_TILE_COLORS_H
+
+#include <dak/quasitiler/tiling.h>
+
+#include <cstdint>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Colors of the tiles, as 0xRRGGBB.
+   //
+   // The tile combinations are colored by groups of as many combinations as
+   // there are dimensions. Each group has two colors, and the color of each
+   // combination in a group is interpolated between them.
+
+   static constexpr int TILE_COLOR_GROUP_COUNT = tiling_t::MAX_DIM / 2;
+
+   using tile_group_colors_t = std::uint32_t[TILE_COLOR_GROUP_COUNT][2];
+
+   // Fill the default colors of the tile groups.
+   void get_default_tile_group_colors(tile_group_colors_t& some_group_colors);
+
+   // The group of a tile combination.
+   int get_tile_color_group(int a_tile_comb, int a_dimensions_count);
+
+   // The color of a tile combination interpolated between the two colors of its group.
+   std::uint32_t interpolate_tile_color(int a_tile_comb, int a_dimensions_count, std::uint32_t a_first_color, std::uint32_t a_second_color);
+
+   // Fill the colors of all the tile combinations of a tiling from the colors
+   // of the tile groups.
+   void interpolate_tile_colors(int a_dimensions_count, const tile_group_colors_t& some_group_colors, std::uint32_t some_tile_colors[tiling_t::MAX_TILE_COMB]);
+}
+
+#endif /* DAK_QUASITILER_TILE_COLORS_H */
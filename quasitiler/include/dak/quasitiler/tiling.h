@@ -8,7 +8,14 @@
 #include <dak/quasitiler/tiling_point.h>
 #include <dak/quasitiler/point_reporter.h>
 #include <dak/quasitiler/interruptor.h>
-
+#include <dak/quasitiler/cylinder_kernel.h>
+#include <dak/quasitiler/dimension_dispatch.h>
+#include <dak/quasitiler/stats.h>
+#include <dak/quasitiler/vertex_generator.h>
+#include <dak/quasitiler/window_polytope.h>
+
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 
@@ -39,6 +46,9 @@ namespace dak::quasitiler
       // The two dimension that all other dimensions are projected on.
       static constexpr int TARGET_DIM = 2;
 
+      // Maximum dimension of the space orthogonal to the tiling plane.
+      static constexpr int WINDOW_DIM = MAX_DIM - TARGET_DIM;
+
 
       ////////////////////////////////////////////////////////////////////////////
       //
@@ -69,8 +79,39 @@ namespace dak::quasitiler
       //
       // generate() returns false if it cannot finish the computation for
       // any reason.
+      //
+      // The points are passed to the reporter in batches, by report_points(),
+      // after report_bounds() has been given the bounds of all the points.
       bool generate(double tiling_bounds[2][MAX_DIM], point_reporter_t& reporter, interruptor_t& an_interruptor);
 
+      // Same as generate() but with a reporter known at compile time, so that
+      // its report_point() can be inlined in the scan. The reporter only needs
+      // a report_point(const vertex_t&) function. Reporters that derive from
+      // point_reporter_t go through the batched generate() instead.
+      template <class REPORTER>
+      bool generate(double tiling_bounds[2][MAX_DIM], REPORTER& reporter, interruptor_t& an_interruptor);
+
+      // Multi-threaded generate(). The scan of the first major coordinate is
+      // split in rows which the worker threads claim one at a time, so faster
+      // threads pick up the slack of slower ones. Each row is buffered and the
+      // buffers are reported in scan order, so the reporter receives exactly
+      // the same points, in the same order, as with the single-threaded
+      // generate().
+      //
+      // The reporter and the interruptor are only called from the calling
+      // thread. A thread count of zero or less uses all available cores.
+      bool generate(double tiling_bounds[2][MAX_DIM], point_reporter_t& reporter, interruptor_t& an_interruptor, int a_thread_count);
+
+      // Lazy generate(): the returned generator produces the same points, in
+      // the same order, but only scans the lattice as the points are taken.
+      // The scan is done one row at a time, so it can be paused after any
+      // point and resumed later without losing the rows already scanned.
+      //
+      // The bounds are copied. The tiling must outlive the generator and
+      // must not be initialized or generated again while it is in use.
+      // is_generated() becomes true once all the points have been produced.
+      vertex_generator_t vertices(const double tiling_bounds[2][MAX_DIM]);
+
       ////////////////////////////////////////////////////////////////////////////
       //
       // Tiling descriptions.
@@ -81,6 +122,39 @@ namespace dak::quasitiler
       const std::vector<int>& signs() const                    { return my_signs; }
       bool                    is_generated() const             { return my_is_generated; }
 
+      // The kernel used to test points against the cylinder. Defaults to
+      // the best one for the running CPU, specialized for the dimension of
+      // the tiling. All kernels give the same results. A kernel specialized
+      // for a dimension can only be used with a tiling of that dimension.
+      const cylinder_kernel_t&   get_cylinder_kernel() const   { return *my_cylinder_kernel; }
+      void                       set_cylinder_kernel(const cylinder_kernel_t& a_kernel) { my_cylinder_kernel = &a_kernel; }
+
+      // How the cylinder criteria are ordered. A point tested against the
+      // criteria is rejected by the first group of criteria it fails, so the
+      // criteria that reject the most points should come first.
+      //
+      // fixed:    the order chosen by compute_cylinder().
+      // adaptive: the first generate() after init() with enough rows samples
+      //           a few rows spread over the scan and orders the criteria
+      //           greedily, each one rejecting the most sampled points that
+      //           the ones before it did not.
+      //
+      // The order never changes which points are generated.
+      enum class criteria_order_t
+      {
+         fixed,
+         adaptive,
+      };
+
+      criteria_order_t           get_criteria_order() const    { return my_criteria_order; }
+      void                       set_criteria_order(criteria_order_t an_order) { my_criteria_order = an_order; }
+
+      // The window of the tiling, computed by init().
+      const window_polytope_t&   get_window_polytope() const   { return my_window_polytope; }
+
+      // Statistics of the last init() and generate(), when enabled. See stats.h.
+      const generate_stats_t&    get_generate_stats() const    { return my_generate_stats; }
+
    private:
       ////////////////////////////////////////////////////////////////////////////
       //
@@ -102,6 +176,22 @@ namespace dak::quasitiler
       // product to compute the orthogonal vector.
       bool compute_cylinder();
 
+      // The window is the projection of the unit cube to the space orthogonal
+      // to the tiling plane. A point is in the cylinder when the projection
+      // of its offset position is in the window. Compute the projection and
+      // a ball inside the window and one containing it, so most points can be
+      // decided by their distance to the origin of the orthogonal space.
+      void compute_window();
+
+      // Transpose the criteria to the columns used by the kernels, in the
+      // given order of the criteria.
+      void fill_cylinder_columns(const int some_criteria[]);
+
+      // Apply the selected criteria order before scanning within the given
+      // bounds, sampling some rows of the scan if the adaptive order is not
+      // yet known.
+      void order_criteria(double tiling_bounds[2][MAX_DIM], const int bounds[2][MAX_DIM], interruptor_t& an_interruptor);
+
       // Initialize the tiling my_coordinate_orders[]. Sort my_coordinate_orders[] wrt the size of the
       // projections of the lattice generators to each of the plane
       // generators.
@@ -119,26 +209,131 @@ namespace dak::quasitiler
       // Find a bounding box for the cylinder in the ambient space.
       // bounds[] is a bounding box of the plane in generators coords.
 
-      void compute_ambient_bounds(double tiling_bounds[2][MAX_DIM], int bounds[2][MAX_DIM]);
+      void compute_ambient_bounds(double tiling_bounds[2][MAX_DIM], int bounds[2][MAX_DIM]) const;
+
+      // Find the bounds of all the lattice points that the scan can report
+      // for the given ambient bounds. The scan clips the tiling plane two units
+      // outside of the tiling bounds and then goes a diagonal away from the
+      // plane, which can be up to three units beyond the ambient bounds.
+      void compute_lattice_bounds(const int bounds[2][MAX_DIM], int lattice_bounds[2][MAX_DIM]) const;
+
+      // Give the lattice bounds to the reporter, if it wants them.
+      template <class REPORTER>
+      void report_bounds(const int bounds[2][MAX_DIM], REPORTER& reporter) const;
+
+      // Scan all the rows of the tiling. Returns false if interrupted.
+      template <class REPORTER>
+      bool scan_rows(double tiling_bounds[2][MAX_DIM], REPORTER& reporter, interruptor_t& an_interruptor);
+
+      // Scan one row of the tiling: all the points where the first major
+      // coordinate has the given value. The bounds are the ones computed by
+      // compute_ambient_bounds(). Returns false if interrupted.
+      //
+      // Specialized for the dimension of the tiling, as selected by
+      // dispatch_dimension(), so that the loops over the coordinates are unrolled.
+      //
+      // When given reject masks, the criteria rejecting each point outside the
+      // cylinder are added to them, as one bit per criterion.
+      template <int DIM, class REPORTER>
+      bool scan_row(double tiling_bounds[2][MAX_DIM], const int bounds[2][MAX_DIM], int a_row, REPORTER& reporter, interruptor_t& an_interruptor,
+                    generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks = nullptr) const;
+
+      // The tiling bounds, copied into the coroutine of vertices().
+      struct plane_bounds_t
+      {
+         double bounds[2][MAX_DIM];
+      };
+
+      // The coroutine of vertices().
+      vertex_generator_t generate_vertices(plane_bounds_t some_bounds);
+
+      // Clear the statistics of the previous generate().
+      void reset_generate_stats();
 
       // Find a point in the tiling plane.  The plane is parametrized by
       // the two main canonical directions.  Use these two main directions
       // in scan_index to determine the point in the plane.  Return the
       // result both in the ambient space coords and the plane coords
-      void do_parametrization(const vertex_t& scan_index, double plane_point[], tiling_point_t& tiling_point);
+      void do_parametrization(const vertex_t& scan_index, double plane_point[], tiling_point_t& tiling_point) const;
 
       // Check if the point is inside the cylinder, with an epsilon leeway.
-      bool in_cylinder(const vertex_t point);
+      bool in_cylinder(const vertex_t point) const;
+
+      // Check if a point in the shell between the balls of the window is
+      // inside the cylinder, with the exact in_cylinder() test.
+      bool in_window_shell(const vertex_t& a_point, generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const;
+
+      // Check if a point is inside the cylinder, given the running values of
+      // the criteria at the point. The running values accumulate rounding
+      // errors, so points that are too close to a face of the cylinder to be
+      // decided by them are verified with the exact in_cylinder() test.
+      bool in_running_criteria(const vertex_t& a_point, const double some_values[], generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const;
+
+      // Record the criteria rejecting a point in the statistics and in the
+      // reject masks, if given and not yet full.
+      void record_criteria_reject(const vertex_t& a_point, generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const;
+
+      // Tests the points of a scan against the cylinder while the scan moves
+      // one coordinate at a time, in one of two ways chosen per dimension.
+      //
+      // With the balls of the window, it keeps the projection of the current
+      // point in the orthogonal space. Most points are decided by the distance
+      // of their projection to the origin: accepted inside the inner ball of
+      // the window, rejected outside its outer ball. Only the points in the
+      // shell between the balls get the exact in_cylinder() test.
+      //
+      // Otherwise, it keeps the value of each criterion for the current point
+      // and tests all points with in_running_criteria().
+      //
+      // Either way, moving along a coordinate only adds the projection or the
+      // column of that coordinate, and the same points are accepted.
+      //
+      // Specialized for the dimension of the tiling, like scan_row().
+      template <int DIM>
+      struct cylinder_scan_t
+      {
+         // The balls are faster than the running criteria at all dimensions
+         // but seven, as measured with quasitiler_benchmark. At dimension
+         // seven, updating the projection costs more than the balls save.
+         static constexpr bool USES_WINDOW_BALLS = (DIM != 7);
+
+         cylinder_scan_t(const tiling_t& a_tiling, generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks)
+            : my_tiling(a_tiling), my_stats(some_stats), my_reject_masks(some_reject_masks)
+         {
+         }
+
+         // Project the given point or compute all the criteria from scratch.
+         void start(const vertex_t& a_point);
+
+         // The coordinate of the current point changed by the given amount.
+         void move(int a_coord, int a_delta);
+
+         // Check if the current point, given again, is inside the cylinder.
+         bool in_cylinder(const vertex_t& a_point) const;
+
+      private:
+         int window_count() const { return dimension_count<DIM>(my_tiling.my_dimensions_count) - TARGET_DIM; }
+
+         const tiling_t&               my_tiling;
+         generate_stats_t&             my_stats;
+         std::vector<std::uint64_t>*   my_reject_masks;
+         double                        my_window_point[WINDOW_DIM];
+         alignas(32) double            my_values[cylinder_columns_t::MAX_PADDED_CRITERIA];
+      };
+
+      // Floor and ceiling as integers.
+      static int my_floor(double x) { const int i = int(x); return x < i ? i - 1 : i; }
+      static int my_ceil(double x)  { const int i = int(x); return x > i ? i + 1 : i; }
 
    private:
       // Now we define elementary vector operations.
-      double dot_product(double x[], double y[]);
+      double dot_product(const double x[], const double y[]) const;
 
       // Computes x = s * y
-      void scalar_mult(double x[], double s, double y[]);
+      void scalar_mult(double x[], double s, const double y[]) const;
 
       // Computes x = x + s * y
-      void add_to(double x[], double s, double y[]);
+      void add_to(double x[], double s, const double y[]) const;
 
    public:
       // Accessed directly by the Drawing class. Oooh, evil.
@@ -148,6 +343,13 @@ namespace dak::quasitiler
       int      tile_generator[MAX_TILE_COMB][2];
 
    private:
+      // Loading a cached drawing counts as generating the tiling,
+      // and so does generating a drawing by the multigrid method or
+      // by inflation, which also tests its points against the window.
+      friend struct drawing_cache_t;
+      friend struct multigrid_drawing_t;
+      friend struct substitution_drawing_t;
+
       double            my_parametrization[TARGET_DIM][TARGET_DIM];
       int               my_coordinate_orders[MAX_DIM] = { 0 };
       std::vector<int>  my_signs;
@@ -156,8 +358,237 @@ namespace dak::quasitiler
       int               my_dimensions_count = 5;
       int               my_cylinder_criteria_count = 0;
       double            my_cylinder_criteria[MAX_CYLR_COMB][MAX_DIM];
+      cylinder_columns_t         my_cylinder_columns;
+      alignas(32) double         my_window_columns[MAX_DIM][WINDOW_DIM];
+      double                     my_inner_window_radius_squared = 0.;
+      double                     my_outer_window_radius_squared = 0.;
+      window_polytope_t          my_window_polytope;
+      criteria_order_t           my_criteria_order = criteria_order_t::fixed;
+      bool                       my_is_criteria_order_sampled = false;
+      const cylinder_kernel_t*   my_cylinder_kernel = &quasitiler::get_cylinder_kernel(my_dimensions_count);
       bool              my_is_generated = false;
+      generate_stats_t  my_generate_stats;
    };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Scan templates.
+
+   template <class REPORTER>
+   bool tiling_t::generate(double tiling_bounds[2][MAX_DIM], REPORTER& reporter, interruptor_t& an_interruptor)
+   {
+      if constexpr (std::is_base_of_v<point_reporter_t, REPORTER>)
+         return generate(tiling_bounds, static_cast<point_reporter_t&>(reporter), an_interruptor);
+      else
+         return scan_rows(tiling_bounds, reporter, an_interruptor);
+   }
+
+   template <class REPORTER>
+   bool tiling_t::scan_rows(double tiling_bounds[2][MAX_DIM], REPORTER& reporter, interruptor_t& an_interruptor)
+   {
+      my_is_generated = false;
+
+      reset_generate_stats();
+      stats_timer_t timer(my_generate_stats.generate_seconds);
+
+      // Find the bounds relative to the ambient space, for the bounds
+      // in the tiling subspace in.
+
+      int bounds[2][MAX_DIM];
+      compute_ambient_bounds(tiling_bounds, bounds);
+
+      order_criteria(tiling_bounds, bounds, an_interruptor);
+      report_bounds(bounds, reporter);
+
+      // Scaning this tiling, one row of the first major coordinate at a time.
+
+      const int row_coord = my_coordinate_orders[0];
+      const bool is_done = dispatch_dimension(my_dimensions_count, [&]<int DIM>()
+      {
+         for (int row = bounds[0][row_coord]; row <= bounds[1][row_coord]; ++row)
+            if (!scan_row<DIM>(tiling_bounds, bounds, row, reporter, an_interruptor, my_generate_stats))
+               return false;
+         return true;
+      });
+
+      if (!is_done)
+         return false;
+
+      my_is_generated = true;
+      return true;
+   }
+
+   template <class REPORTER>
+   void tiling_t::report_bounds(const int bounds[2][MAX_DIM], REPORTER& reporter) const
+   {
+      if constexpr (requires(int lattice_bounds[2][MAX_DIM]) { reporter.report_bounds(lattice_bounds, 0); })
+      {
+         int lattice_bounds[2][MAX_DIM];
+         compute_lattice_bounds(bounds, lattice_bounds);
+         reporter.report_bounds(lattice_bounds, my_dimensions_count);
+      }
+   }
+
+   template <int DIM, class REPORTER>
+   bool tiling_t::scan_row(double tiling_bounds[2][MAX_DIM], const int bounds[2][MAX_DIM], int a_row, REPORTER& reporter, interruptor_t& an_interruptor,
+                           generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const
+   {
+      const int dim_count = dimension_count<DIM>(my_dimensions_count);
+
+      // Initialize the indices for the scaning of this row.
+
+      vertex_t scan_index;
+      scan_index.coords[my_coordinate_orders[0]] = a_row;
+      scan_index.coords[my_coordinate_orders[1]] = bounds[0][my_coordinate_orders[1]];
+
+      // Scaning this row.
+
+      constexpr double diag = 1.4142135623730951;
+      double plane_point[MAX_DIM];
+      tiling_point_t tiling_point;
+      cylinder_scan_t<DIM> cylinder_scan(*this, some_stats, some_reject_masks);
+      while (scan_index.coords[my_coordinate_orders[1]] <= bounds[1][my_coordinate_orders[1]])
+      {
+         // Find the next point in the tiling my_parametrization.
+
+         do_parametrization(scan_index, plane_point, tiling_point);
+
+         if constexpr (STATS_ENABLED)
+            ++some_stats.plane_points;
+
+         // Do some preliminary clipping here.
+
+         if (tiling_point.x > (tiling_bounds[0][0] - 2.0f)
+            && tiling_point.x < (tiling_bounds[1][0] + 2.0f)
+            && tiling_point.y >(tiling_bounds[0][1] - 2.0f)
+            && tiling_point.y < (tiling_bounds[1][1] + 2.0f))
+         {
+            if constexpr (STATS_ENABLED)
+               ++some_stats.clipped_plane_points;
+
+            // Find the bounds for the intersection of the tiling's
+            // plane with the remaining coordinates.
+
+            int local_bounds[2][MAX_DIM];
+            for (int dim = TARGET_DIM; dim < dim_count; ++dim)
+            {
+               local_bounds[0][my_coordinate_orders[dim]] = my_ceil(plane_point[my_coordinate_orders[dim]] - diag);
+               local_bounds[1][my_coordinate_orders[dim]] = my_floor(plane_point[my_coordinate_orders[dim]] + diag);
+            }
+
+            // Scan for all the intersecting points above the current
+            // plane_point.
+
+            for (int ind = TARGET_DIM; ind < dim_count; ++ind)
+               scan_index.coords[my_coordinate_orders[ind]] = local_bounds[0][my_coordinate_orders[ind]];
+
+            cylinder_scan.start(scan_index);
+
+            // Scaning.
+
+            while (scan_index.coords[my_coordinate_orders[TARGET_DIM]] <= local_bounds[1][my_coordinate_orders[TARGET_DIM]])
+            {
+               const bool is_inside = cylinder_scan.in_cylinder(scan_index);
+               if (is_inside)
+                  reporter.report_point(scan_index);
+
+               if constexpr (STATS_ENABLED)
+               {
+                  ++some_stats.candidates;
+                  some_stats.accepted += is_inside;
+               }
+
+               // Increment the scan_index to the next point. A carry moves
+               // the coordinate back to its start, undoing its columns.
+
+               int ind = dim_count - 1;
+               while ((++(scan_index.coords[my_coordinate_orders[ind]])) > local_bounds[1][my_coordinate_orders[ind]]
+                  && ind > TARGET_DIM)
+               {
+                  const int coord = my_coordinate_orders[ind];
+                  cylinder_scan.move(coord, local_bounds[0][coord] - local_bounds[1][coord]);
+                  scan_index.coords[coord] = local_bounds[0][coord];
+                  ind--;
+               }
+               cylinder_scan.move(my_coordinate_orders[ind], 1);
+            }
+         }
+
+         // Find the next point in the scaning in the my_parametrization.
+
+         ++scan_index.coords[my_coordinate_orders[1]];
+
+         // Should we abort the computation.
+
+         if (an_interruptor.interrupted())
+            return false;
+      }
+
+      return true;
+   }
+
+   template <int DIM>
+   void tiling_t::cylinder_scan_t<DIM>::start(const vertex_t& a_point)
+   {
+      double trans_point[MAX_DIM];
+      for (int ind = 0; ind < dimension_count<DIM>(my_tiling.my_dimensions_count); ++ind)
+         trans_point[ind] = a_point.coords[ind] - my_tiling.offset[ind];
+
+      if constexpr (USES_WINDOW_BALLS)
+      {
+         for (int dim = 0; dim < window_count(); ++dim)
+            my_window_point[dim] = 0.;
+
+         for (int ind = 0; ind < dimension_count<DIM>(my_tiling.my_dimensions_count); ++ind)
+            for (int dim = 0; dim < window_count(); ++dim)
+               my_window_point[dim] += trans_point[ind] * my_tiling.my_window_columns[ind][dim];
+      }
+      else
+      {
+         my_tiling.my_cylinder_kernel->evaluate(my_tiling.my_cylinder_columns, trans_point, my_values);
+      }
+   }
+
+   template <int DIM>
+   void tiling_t::cylinder_scan_t<DIM>::move(int a_coord, int a_delta)
+   {
+      if constexpr (USES_WINDOW_BALLS)
+      {
+         for (int dim = 0; dim < window_count(); ++dim)
+            my_window_point[dim] += a_delta * my_tiling.my_window_columns[a_coord][dim];
+      }
+      else
+      {
+         my_tiling.my_cylinder_kernel->move(my_tiling.my_cylinder_columns, a_coord, a_delta, my_values);
+      }
+   }
+
+   template <int DIM>
+   bool tiling_t::cylinder_scan_t<DIM>::in_cylinder(const vertex_t& a_point) const
+   {
+      if constexpr (!USES_WINDOW_BALLS)
+         return my_tiling.in_running_criteria(a_point, my_values, my_stats, my_reject_masks);
+
+      double norm = 0.;
+      for (int dim = 0; dim < window_count(); ++dim)
+         norm += my_window_point[dim] * my_window_point[dim];
+
+      if (norm < my_tiling.my_inner_window_radius_squared)
+      {
+         if constexpr (STATS_ENABLED)
+            ++my_stats.inner_accepts;
+         return true;
+      }
+
+      if (norm > my_tiling.my_outer_window_radius_squared)
+      {
+         if constexpr (STATS_ENABLED)
+            ++my_stats.outer_rejects;
+         return false;
+      }
+
+      return my_tiling.in_window_shell(a_point, my_stats, my_reject_masks);
+   }
 }
 
 #endif /* DAK_QUASITILER_TILING_H */
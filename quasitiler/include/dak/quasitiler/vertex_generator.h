@@ -0,0 +1,134 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_VERTEX_GENERATOR_H
+#define DAK_QUASITILER_VERTEX_GENERATOR_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Lazy sequence of lattice points, produced by a coroutine that only runs
+   // when the next point is needed. The points can be taken a few at a time,
+   // for example a few per frame of an interactive program, and the sequence
+   // can be left at any point and resumed later without starting over.
+   //
+   // begin() resumes the coroutine: each begin() continues after the last
+   // point seen, so a loop over the generator can be left early and started
+   // again. std::views::take() looks at one point past the ones it takes,
+   // which would then be skipped: use take_points() instead.
+   //
+   // The generator is move-only and destroys its coroutine when destroyed.
+
+   struct vertex_generator_t
+   {
+      struct promise_type
+      {
+         vertex_generator_t get_return_object()
+         {
+            return vertex_generator_t(std::coroutine_handle<promise_type>::from_promise(*this));
+         }
+
+         std::suspend_always initial_suspend() noexcept { return {}; }
+         std::suspend_always final_suspend() noexcept   { return {}; }
+
+         // The point stays in the coroutine until it is resumed.
+         std::suspend_always yield_value(const vertex_t& a_point) noexcept
+         {
+            my_point = &a_point;
+            return {};
+         }
+
+         void return_void() { }
+         void unhandled_exception() { throw; }
+
+         const vertex_t* my_point = nullptr;
+      };
+
+      // Input iterator over the remaining points.
+      struct iterator
+      {
+         using iterator_category = std::input_iterator_tag;
+         using value_type = vertex_t;
+         using difference_type = std::ptrdiff_t;
+
+         iterator() = default;
+         explicit iterator(vertex_generator_t* a_generator) : my_generator(a_generator) { }
+
+         const vertex_t& operator*() const { return my_generator->current(); }
+         const vertex_t* operator->() const { return &my_generator->current(); }
+
+         iterator& operator++() { my_generator->advance(); return *this; }
+         void operator++(int) { my_generator->advance(); }
+
+         bool operator==(std::default_sentinel_t) const { return my_generator->is_done(); }
+
+      private:
+         vertex_generator_t* my_generator = nullptr;
+      };
+
+      vertex_generator_t() = default;
+      vertex_generator_t(vertex_generator_t&& an_other) noexcept : my_coroutine(std::exchange(an_other.my_coroutine, nullptr)) { }
+      vertex_generator_t& operator=(vertex_generator_t&& an_other) noexcept
+      {
+         if (this != &an_other)
+         {
+            destroy();
+            my_coroutine = std::exchange(an_other.my_coroutine, nullptr);
+         }
+         return *this;
+      }
+      ~vertex_generator_t() { destroy(); }
+
+      // Resume with the next point.
+      iterator begin() { advance(); return iterator(this); }
+      std::default_sentinel_t end() const { return std::default_sentinel; }
+
+      // Verify if all the points have been produced.
+      bool is_done() const { return !my_coroutine || my_coroutine.done(); }
+
+      // Report at most the given number of the next points to the reporter,
+      // which only needs a report_point(const vertex_t&) function. Returns
+      // how many were reported: fewer when the points run out.
+      template <class REPORTER>
+      size_t take_points(REPORTER& a_reporter, size_t a_max_count)
+      {
+         size_t count = 0;
+         for (; count < a_max_count && advance(); ++count)
+            a_reporter.report_point(current());
+         return count;
+      }
+
+   private:
+      explicit vertex_generator_t(std::coroutine_handle<promise_type> a_coroutine) : my_coroutine(a_coroutine) { }
+
+      // Run the coroutine up to its next point. Returns false when done.
+      bool advance()
+      {
+         if (is_done())
+            return false;
+         my_coroutine.resume();
+         return !my_coroutine.done();
+      }
+
+      const vertex_t& current() const { return *my_coroutine.promise().my_point; }
+
+      void destroy()
+      {
+         if (my_coroutine)
+            my_coroutine.destroy();
+         my_coroutine = nullptr;
+      }
+
+      std::coroutine_handle<promise_type> my_coroutine;
+   };
+}
+
+#endif /* DAK_QUASITILER_VERTEX_GENERATOR_H */
@@ -0,0 +1,226 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_VERTEX_INDEX_H
+#define DAK_QUASITILER_VERTEX_INDEX_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Hash slots of a list of vertices, shared by vertex_index_t and
+   // vertex_table_t. Each slot holds the position of a vertex in the list,
+   // or EMPTY. Uses open addressing with linear probing, so a lookup is a
+   // few probes in a single flat array.
+   //
+   // The list is either full vertices, of which only the first
+   // dimensions_count coordinates are used, the others assumed to be zero,
+   // or packed vertex keys.
+
+   struct vertex_slots_t
+   {
+      // Value of the slots that hold no vertex.
+      static constexpr size_t EMPTY = size_t(-1);
+
+      explicit vertex_slots_t(int a_dimensions_count = 0) : my_dimensions_count(a_dimensions_count) { }
+
+      // Empty all the slots, with room for the given number of vertices.
+      // The slots are kept at most half full so probe sequences stay short.
+      void allocate(size_t a_count);
+
+      size_t capacity() const { return my_slots.size(); }
+
+      // The slot holding the position of the vertex in the list, or else
+      // the empty slot where its position would go.
+      template <class KEY>
+      size_t& probe(const std::vector<KEY>& some_keys, const KEY& a_key)       { return my_slots[find_slot(some_keys, a_key)]; }
+      template <class KEY>
+      size_t  probe(const std::vector<KEY>& some_keys, const KEY& a_key) const { return my_slots[find_slot(some_keys, a_key)]; }
+
+      // Put the position of a vertex of the list in its slot, keeping the
+      // lowest position of equal vertices. Can be called from multiple
+      // threads at once, but not while the slots are otherwise used.
+      template <class KEY>
+      void insert_shared(const std::vector<KEY>& some_keys, size_t a_key_index);
+
+   private:
+      template <class KEY>
+      size_t find_slot(const std::vector<KEY>& some_keys, const KEY& a_key) const;
+
+      size_t hash(const vertex_t& a_vertex) const;
+      size_t hash(uint64_t a_key) const;
+      bool   is_same(const vertex_t& a_vertex, const vertex_t& an_other) const;
+      bool   is_same(uint64_t a_key, uint64_t an_other) const { return a_key == an_other; }
+
+      std::vector<size_t>  my_slots;
+      size_t               my_mask = 0;
+      int                  my_shift = 0;
+      int                  my_dimensions_count = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Hash index of a list of vertices, to find the position of a vertex
+   // in the list in constant time.
+
+   struct vertex_index_t
+   {
+      // Returned by find() when the vertex is not in the list.
+      static constexpr size_t NOT_FOUND = vertex_slots_t::EMPTY;
+
+      // Build the index of the given vertices or keys on the given number
+      // of threads, zero using all cores. They are not copied, so they must
+      // outlive the index and not be modified.
+      vertex_index_t(const std::vector<vertex_t>& some_vertices, int a_dimensions_count, int a_thread_count = 1);
+      vertex_index_t(const std::vector<uint64_t>& some_keys, int a_thread_count = 1);
+
+      // Find the position of the vertex in the list, or NOT_FOUND.
+      size_t find(const vertex_t& a_vertex) const { return my_vertices ? my_slots.probe(*my_vertices, a_vertex) : NOT_FOUND; }
+      size_t find(uint64_t a_key) const           { return my_keys ? my_slots.probe(*my_keys, a_key) : NOT_FOUND; }
+
+      // Verify if the vertex is in the list.
+      bool contains(const vertex_t& a_vertex) const { return find(a_vertex) != NOT_FOUND; }
+      bool contains(uint64_t a_key) const           { return find(a_key) != NOT_FOUND; }
+
+   private:
+      template <class KEY>
+      void insert_all(const std::vector<KEY>& some_keys, int a_thread_count);
+
+      const std::vector<vertex_t>*  my_vertices = nullptr;
+      const std::vector<uint64_t>*  my_keys = nullptr;
+      vertex_slots_t                my_slots;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Table of distinct vertices, either full vertices or packed vertex keys,
+   // kept in the order they are first inserted, with a hash index to find
+   // them. Unlike vertex_index_t, the table owns the vertices and the index
+   // grows as they are inserted.
+
+   template <class KEY>
+   struct vertex_table_t
+   {
+      // Reserve room for the expected number of vertices. Full vertices only
+      // use their first dimensions_count coordinates, the others must be zero.
+      vertex_table_t(size_t an_expected_count, int a_dimensions_count);
+
+      // Insert the vertex if it is not yet in the table. Returns its position
+      // and whether it was inserted.
+      std::pair<size_t, bool> insert(const KEY& a_key);
+
+      // The distinct vertices, in insertion order.
+      std::vector<KEY> keys;
+
+   private:
+      void rehash();
+
+      vertex_slots_t my_slots;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vertex slots inline functions.
+
+   template <class KEY>
+   size_t vertex_slots_t::find_slot(const std::vector<KEY>& some_keys, const KEY& a_key) const
+   {
+      for (size_t slot = hash(a_key); ; slot = (slot + 1) & my_mask)
+      {
+         const size_t key_index = my_slots[slot];
+         if (key_index == EMPTY || is_same(a_key, some_keys[key_index]))
+            return slot;
+      }
+   }
+
+   template <class KEY>
+   void vertex_slots_t::insert_shared(const std::vector<KEY>& some_keys, size_t a_key_index)
+   {
+      const KEY& key = some_keys[a_key_index];
+      for (size_t slot = hash(key); ; slot = (slot + 1) & my_mask)
+      {
+         // Claim the slot if it is empty, replace a higher position of the
+         // same vertex, or else probe the next slot. A failed exchange
+         // reloads the slot, which may now hold the same vertex.
+         std::atomic_ref<size_t> key_index_ref(my_slots[slot]);
+         size_t key_index = key_index_ref.load(std::memory_order_relaxed);
+         while (key_index == EMPTY || is_same(key, some_keys[key_index]))
+         {
+            if (key_index != EMPTY && key_index <= a_key_index)
+               return;
+            if (key_index_ref.compare_exchange_weak(key_index, a_key_index, std::memory_order_relaxed))
+               return;
+         }
+      }
+   }
+
+   // Multiplicative hashing: mix each coordinate in and keep the high bits,
+   // which depend on all the coordinates. Neighboring vertices differ by one
+   // in a single coordinate, so the low bits would cluster.
+
+   inline size_t vertex_slots_t::hash(const vertex_t& a_vertex) const
+   {
+      uint64_t hash = 0;
+      for (int ind = 0; ind < my_dimensions_count; ++ind)
+         hash = (hash + uint32_t(a_vertex.coords[ind])) * 0x9E3779B97F4A7C15ull;
+      return size_t(hash >> my_shift);
+   }
+
+   inline size_t vertex_slots_t::hash(uint64_t a_key) const
+   {
+      const uint64_t hash = (a_key ^ (a_key >> 32)) * 0x9E3779B97F4A7C15ull;
+      return size_t(hash >> my_shift);
+   }
+
+   inline bool vertex_slots_t::is_same(const vertex_t& a_vertex, const vertex_t& an_other) const
+   {
+      for (int ind = 0; ind < my_dimensions_count; ++ind)
+         if (a_vertex.coords[ind] != an_other.coords[ind])
+            return false;
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vertex table templates.
+
+   template <class KEY>
+   vertex_table_t<KEY>::vertex_table_t(size_t an_expected_count, int a_dimensions_count)
+      : my_slots(a_dimensions_count)
+   {
+      keys.reserve(an_expected_count);
+      my_slots.allocate(an_expected_count);
+   }
+
+   template <class KEY>
+   std::pair<size_t, bool> vertex_table_t<KEY>::insert(const KEY& a_key)
+   {
+      size_t& key_index = my_slots.probe(keys, a_key);
+      if (key_index != vertex_slots_t::EMPTY)
+         return { key_index, false };
+
+      key_index = keys.size();
+      keys.emplace_back(a_key);
+      if (keys.size() * 2 > my_slots.capacity())
+         rehash();
+      return { keys.size() - 1, true };
+   }
+
+   template <class KEY>
+   void vertex_table_t<KEY>::rehash()
+   {
+      my_slots.allocate(keys.size() * 2);
+      for (size_t key_index = 0; key_index < keys.size(); ++key_index)
+         my_slots.probe(keys, keys[key_index]) = key_index;
+   }
+}
+
+#endif /* DAK_QUASITILER_VERTEX_INDEX_H */
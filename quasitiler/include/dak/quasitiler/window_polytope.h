@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_WINDOW_POLYTOPE_H
+#define DAK_QUASITILER_WINDOW_POLYTOPE_H
+
+#include <dak/quasitiler/point_reporter.h>
+
+#include <utility>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // The window of a tiling: the projection of the unit cube [-1/2, 1/2]^n
+   // of the lattice to the space orthogonal to the tiling plane, with its
+   // vertices and its facets.
+   //
+   // The window is a zonotope: the sum of the projected lattice generators,
+   // each scaled to [-1/2, 1/2]. Each facet is parallel to all but three of
+   // the projected generators, so each pair of opposite facets is one of the
+   // criteria of the cylinder of the tiling. The facets are kept in pairs:
+   // facet 2k + 1 is opposite to facet 2k.
+
+   struct window_polytope_t
+   {
+      static constexpr int MAX_DIM = vertex_t::MAX_DIM;
+      static constexpr int WINDOW_DIM = MAX_DIM - 2;
+
+      // A point of the orthogonal space.
+      struct point_t
+      {
+         double coords[WINDOW_DIM] = { };
+      };
+
+      // A facet: the points of the window are those whose dot product with
+      // its outward unit normal is at most its distance from the origin.
+      struct facet_t
+      {
+         point_t           normal;
+         double            distance = 0.;
+         std::vector<int>  vertices;
+      };
+
+      // Empty window.
+      window_polytope_t() = default;
+
+      // Build the window from the projections of the lattice generators:
+      // the orthogonal coordinates of the generator ind are in some_columns[ind].
+      window_polytope_t(const double some_columns[MAX_DIM][WINDOW_DIM], int a_dimensions_count);
+
+      // Dimension of the orthogonal space.
+      int window_dimensions_count() const { return my_window_dimensions_count; }
+
+      // Vertices and facets of the window.
+      const std::vector<point_t>& get_vertices() const { return my_vertices; }
+      const std::vector<facet_t>& get_facets() const   { return my_facets; }
+
+      // Radius of the largest ball around the origin inside the window
+      // and of the smallest ball containing it.
+      double get_inner_radius() const { return my_inner_radius; }
+      double get_outer_radius() const { return my_outer_radius; }
+
+   private:
+      // Facets orthogonal to all but three projected generators.
+      void compute_facets();
+
+      // Vertices of the window on the facets, and which facets they are on.
+      void compute_vertices();
+
+      double dot_product(const point_t& a_point, const point_t& an_other) const;
+
+      point_t              my_columns[MAX_DIM];
+      int                  my_dimensions_count = 0;
+      int                  my_window_dimensions_count = 0;
+      std::vector<point_t> my_vertices;
+      std::vector<facet_t> my_facets;
+
+      // The generators going out of and into each facet, as bits.
+      std::vector<std::pair<int, int>> my_facet_signs;
+      double               my_inner_radius = 0.;
+      double               my_outer_radius = 0.;
+   };
+}
+
+#endif /* DAK_QUASITILER_WINDOW_POLYTOPE_H */
@@ -0,0 +1,109 @@
+#include <dak/quasitiler/buffered_writer.h>
+
+#include <algorithm>
+
+
+namespace dak::quasitiler
+{
+   buffered_writer_t::buffered_writer_t(size_t a_buffer_size, size_t a_max_pending_count)
+      : my_buffer_size(std::max<size_t>(1, a_buffer_size))
+      , my_max_pending_count(std::max<size_t>(1, a_max_pending_count))
+   {
+   }
+
+   buffered_writer_t::~buffered_writer_t()
+   {
+      close();
+   }
+
+   bool buffered_writer_t::open(const std::filesystem::path& a_file_name)
+   {
+      close();
+
+   #ifdef _WIN32
+      my_file = _wfopen(a_file_name.c_str(), L"wb");
+   #else
+      my_file = std::fopen(a_file_name.c_str(), "wb");
+   #endif
+      if (!my_file)
+         return false;
+
+      // The data is already buffered, avoid copying it again.
+      std::setvbuf(my_file, nullptr, _IONBF, 0);
+
+      my_buffer.clear();
+      my_buffer.reserve(my_buffer_size + my_buffer_size / 4);
+      my_is_closing = false;
+      my_has_failed = false;
+      my_thread = std::thread([this]() { write_pending(); });
+
+      return true;
+   }
+
+   bool buffered_writer_t::close()
+   {
+      if (!my_file)
+         return false;
+
+      if (!my_buffer.empty())
+         hand_off();
+
+      {
+         std::lock_guard lock(my_mutex);
+         my_is_closing = true;
+      }
+      my_changed.notify_all();
+      my_thread.join();
+
+      const bool has_failed = (std::fclose(my_file) != 0) || my_has_failed;
+      my_file = nullptr;
+      my_free.clear();
+
+      return !has_failed;
+   }
+
+   void buffered_writer_t::hand_off()
+   {
+      std::unique_lock lock(my_mutex);
+      my_changed.wait(lock, [this]() { return my_pending.size() < my_max_pending_count; });
+
+      my_pending.emplace_back(std::move(my_buffer));
+      if (my_free.empty())
+      {
+         my_buffer = std::string();
+         my_buffer.reserve(my_buffer_size + my_buffer_size / 4);
+      }
+      else
+      {
+         my_buffer = std::move(my_free.back());
+         my_free.pop_back();
+      }
+
+      lock.unlock();
+      my_changed.notify_all();
+   }
+
+   void buffered_writer_t::write_pending()
+   {
+      std::unique_lock lock(my_mutex);
+      while (true)
+      {
+         my_changed.wait(lock, [this]() { return my_is_closing || !my_pending.empty(); });
+         if (my_pending.empty())
+            return;
+
+         // Write without holding the lock, the buffer stays at the front
+         // so that the pending count includes it.
+         std::string& data = my_pending.front();
+         lock.unlock();
+         const bool has_failed = (std::fwrite(data.data(), 1, data.size(), my_file) != data.size());
+         lock.lock();
+
+         my_has_failed |= has_failed;
+         data.clear();
+         my_free.emplace_back(std::move(data));
+         my_pending.pop_front();
+         my_changed.notify_all();
+      }
+   }
+}
@@ -0,0 +1,113 @@
+#include <dak/quasitiler/chunked_drawing.h>
+
+#include <cmath>
+#include <algorithm>
+
+
+namespace dak::quasitiler
+{
+   static constexpr int TARGET_DIM = tiling_t::TARGET_DIM;
+
+   tiling_point_t chunked_drawing_t::get_tile_center(int a_tile_comb, const vertex_t& a_vertex) const
+   {
+      const int gen0 = my_tiling->tile_generator[a_tile_comb][0];
+      const int gen1 = my_tiling->tile_generator[a_tile_comb][1];
+
+      double center[TARGET_DIM];
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+      {
+         center[dim] = (my_tiling->generator[dim][gen0] + my_tiling->generator[dim][gen1]) * 0.5;
+         for (int ind = 0; ind < my_tiling->dimensions_count(); ++ind)
+            center[dim] += (a_vertex.coords[ind] - my_tiling->offset[ind]) * my_tiling->generator[dim][ind];
+      }
+
+      return tiling_point_t(center[0], center[1]);
+   }
+
+   double chunked_drawing_t::get_generator_reach() const
+   {
+      double reach = 0.;
+      for (int ind = 0; ind < my_tiling->dimensions_count(); ++ind)
+      {
+         const double x = my_tiling->generator[0][ind];
+         const double y = my_tiling->generator[1][ind];
+         reach = std::max(reach, std::sqrt(x * x + y * y));
+      }
+      return reach;
+   }
+
+   bool chunked_drawing_t::generate(double tiling_bounds[2][tiling_t::MAX_DIM], chunk_reporter_t& reporter, interruptor_t& an_interruptor)
+   {
+      // The region containing the center of the tiles to report, split in chunks.
+
+      const double reach = get_generator_reach();
+
+      double owned_bounds[2][TARGET_DIM];
+      double chunk_sizes[TARGET_DIM];
+      int chunk_counts[TARGET_DIM];
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+      {
+         owned_bounds[0][dim] = tiling_bounds[0][dim] - reach;
+         owned_bounds[1][dim] = tiling_bounds[1][dim] + reach;
+         const double width = owned_bounds[1][dim] - owned_bounds[0][dim];
+         chunk_sizes[dim] = my_chunk_size > 0. ? my_chunk_size : width;
+         chunk_counts[dim] = std::max(1, (int)std::ceil(width / chunk_sizes[dim]));
+      }
+
+      // The tiles of the vertices within the halo are located correctly:
+      // the vertex of an owned tile is within reach of its center and its
+      // neighbors are within reach of it. Add one for good measure.
+
+      const double halo = 2. * reach + 1.;
+
+      for (int row = 0; row < chunk_counts[1]; ++row)
+      {
+         for (int col = 0; col < chunk_counts[0]; ++col)
+         {
+            const int chunk_index[TARGET_DIM] = { col, row };
+
+            double chunk_bounds[2][tiling_t::MAX_DIM];
+            std::copy(tiling_bounds[0], tiling_bounds[0] + tiling_t::MAX_DIM, chunk_bounds[0]);
+            std::copy(tiling_bounds[1], tiling_bounds[1] + tiling_t::MAX_DIM, chunk_bounds[1]);
+            for (int dim = 0; dim < TARGET_DIM; ++dim)
+            {
+               chunk_bounds[0][dim] = owned_bounds[0][dim] + chunk_index[dim] * chunk_sizes[dim] - halo;
+               chunk_bounds[1][dim] = owned_bounds[0][dim] + (chunk_index[dim] + 1) * chunk_sizes[dim] + halo;
+            }
+
+            drawing_t chunk(my_tiling);
+            chunk.set_tile_search(my_tile_search);
+            if (!my_tiling->generate(chunk_bounds, chunk, an_interruptor, my_thread_count))
+               return false;
+            if (!chunk.locate_tiles(an_interruptor, my_thread_count))
+               return false;
+
+            // Only keep the tiles whose center is in this chunk. The chunk
+            // index is computed the same way for all chunks, so exactly one
+            // chunk owns each tile. The last chunks can extend past the
+            // region, so the region is verified too.
+
+            for (int comb = 0; comb < my_tiling->tile_combinations_count(); ++comb)
+            {
+               std::erase_if(chunk.my_tile_storage[comb], [&](size_t a_vertex_index)
+               {
+                  const tiling_point_t center = get_tile_center(comb, chunk.my_vertex_storage[a_vertex_index]);
+                  const double coords[TARGET_DIM] = { center.x, center.y };
+                  for (int dim = 0; dim < TARGET_DIM; ++dim)
+                  {
+                     if (coords[dim] < owned_bounds[0][dim] || coords[dim] >= owned_bounds[1][dim])
+                        return true;
+                     if (std::floor((coords[dim] - owned_bounds[0][dim]) / chunk_sizes[dim]) != chunk_index[dim])
+                        return true;
+                  }
+                  return false;
+               });
+            }
+
+            reporter.report_chunk(chunk);
+         }
+      }
+
+      return true;
+   }
+}
@@ -0,0 +1,32 @@
+#include <dak/quasitiler/cpu_features.h>
+
+
+namespace dak::quasitiler
+{
+   bool is_avx2_supported()
+   {
+   #if !defined(DAK_QUASITILER_HAS_X86_SIMD)
+      return false;
+   #elif defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7)
+         return false;
+
+      __cpuid(info, 1);
+      const bool has_avx = (info[2] & (1 << 28)) != 0;
+      const bool has_os_save = (info[2] & (1 << 27)) != 0;
+      if (!has_avx || !has_os_save)
+         return false;
+
+      // The OS must save the AVX registers.
+      if ((_xgetbv(0) & 6) != 6)
+         return false;
+
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+   #else
+      return __builtin_cpu_supports("avx2");
+   #endif
+   }
+}
@@ -0,0 +1,332 @@
+#include <dak/quasitiler/cylinder_kernel.h>
+#include <dak/quasitiler/cpu_features.h>
+#include <dak/quasitiler/dimension_dispatch.h>
+
+#include <cmath>
+
+
+namespace dak::quasitiler
+{
+   using position_t = cylinder_kernel_t::position_t;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Counts of the loops of the kernels. All kernels are specialized for
+   // each dimension, so that the loops have constant trip counts and get
+   // unrolled, with a zero dimension for the generic kernels.
+
+   namespace
+   {
+      template <int DIM>
+      int dimensions_count(const cylinder_columns_t& some_columns)
+      {
+         return dimension_count<DIM>(some_columns.dimensions_count);
+      }
+
+      template <int DIM>
+      int criteria_count(const cylinder_columns_t& some_columns)
+      {
+         if constexpr (DIM > 0)
+            return DIM * (DIM - 1) * (DIM - 2) / 6;
+         else
+            return some_columns.criteria_count;
+      }
+
+      template <int DIM>
+      int padded_criteria_count(const cylinder_columns_t& some_columns)
+      {
+         constexpr int align = cylinder_columns_t::CRITERIA_ALIGN;
+         if constexpr (DIM > 0)
+            return (criteria_count<DIM>(some_columns) + align - 1) / align * align;
+         else
+            return some_columns.padded_criteria_count;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Scalar kernel.
+
+   namespace
+   {
+      template <int DIM>
+      void scalar_evaluate(const cylinder_columns_t& some_columns, const double a_trans_point[], double some_values[])
+      {
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); ++crit)
+         {
+            double dot_p = 0.0f;
+            for (int dim = 0; dim < dimensions_count<DIM>(some_columns); ++dim)
+               dot_p += some_columns.columns[dim][crit] * a_trans_point[dim];
+            some_values[crit] = dot_p;
+         }
+      }
+
+      template <int DIM>
+      bool scalar_contains(const cylinder_columns_t& some_columns, const double a_trans_point[], double an_epsilon)
+      {
+         for (int crit = 0; crit < criteria_count<DIM>(some_columns); ++crit)
+         {
+            double dot_p = 0.0f;
+            for (int dim = 0; dim < dimensions_count<DIM>(some_columns); ++dim)
+               dot_p += some_columns.columns[dim][crit] * a_trans_point[dim];
+            double ans = 1.0f - std::abs(dot_p);
+            if (ans < an_epsilon) return false;  // outside.
+         }
+         return true;
+      }
+
+      template <int DIM>
+      void scalar_move(const cylinder_columns_t& some_columns, int a_coord, double a_delta, double some_values[])
+      {
+         const double* column = some_columns.columns[a_coord];
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); ++crit)
+            some_values[crit] += a_delta * column[crit];
+      }
+
+      template <int DIM>
+      position_t scalar_classify(const cylinder_columns_t& some_columns, const double some_values[], double an_inside_limit, double an_outside_limit)
+      {
+         position_t position = position_t::inside;
+         for (int crit = 0; crit < criteria_count<DIM>(some_columns); ++crit)
+         {
+            const double value = std::abs(some_values[crit]);
+            if (value >= an_inside_limit)
+            {
+               if (value > an_outside_limit)
+                  return position_t::outside;
+               position = position_t::uncertain;
+            }
+         }
+         return position;
+      }
+
+      template <int DIM>
+      const cylinder_kernel_t scalar_kernel =
+      {
+         "scalar", scalar_evaluate<DIM>, scalar_contains<DIM>, scalar_move<DIM>, scalar_classify<DIM>,
+      };
+   }
+
+#ifdef DAK_QUASITILER_HAS_X86_SIMD
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // SSE2 kernel, two criteria per instruction, two registers at a time.
+
+   namespace
+   {
+      template <int DIM>
+      DAK_QUASITILER_TARGET("sse2")
+      inline void sse2_dot(const cylinder_columns_t& some_columns, const double a_trans_point[], int crit, __m128d& dot_lo, __m128d& dot_hi)
+      {
+         dot_lo = _mm_setzero_pd();
+         dot_hi = _mm_setzero_pd();
+         for (int dim = 0; dim < dimensions_count<DIM>(some_columns); ++dim)
+         {
+            const __m128d coord = _mm_set1_pd(a_trans_point[dim]);
+            dot_lo = _mm_add_pd(dot_lo, _mm_mul_pd(_mm_load_pd(some_columns.columns[dim] + crit), coord));
+            dot_hi = _mm_add_pd(dot_hi, _mm_mul_pd(_mm_load_pd(some_columns.columns[dim] + crit + 2), coord));
+         }
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("sse2")
+      void sse2_evaluate(const cylinder_columns_t& some_columns, const double a_trans_point[], double some_values[])
+      {
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 4)
+         {
+            __m128d dot_lo, dot_hi;
+            sse2_dot<DIM>(some_columns, a_trans_point, crit, dot_lo, dot_hi);
+            _mm_storeu_pd(some_values + crit, dot_lo);
+            _mm_storeu_pd(some_values + crit + 2, dot_hi);
+         }
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("sse2")
+      bool sse2_contains(const cylinder_columns_t& some_columns, const double a_trans_point[], double an_epsilon)
+      {
+         const __m128d sign = _mm_set1_pd(-0.0);
+         const __m128d one = _mm_set1_pd(1.0);
+         const __m128d epsilon = _mm_set1_pd(an_epsilon);
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 4)
+         {
+            __m128d dot_lo, dot_hi;
+            sse2_dot<DIM>(some_columns, a_trans_point, crit, dot_lo, dot_hi);
+            const __m128d ans_lo = _mm_sub_pd(one, _mm_andnot_pd(sign, dot_lo));
+            const __m128d ans_hi = _mm_sub_pd(one, _mm_andnot_pd(sign, dot_hi));
+            const __m128d outside = _mm_or_pd(_mm_cmplt_pd(ans_lo, epsilon), _mm_cmplt_pd(ans_hi, epsilon));
+            if (_mm_movemask_pd(outside))
+               return false;
+         }
+         return true;
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("sse2")
+      void sse2_move(const cylinder_columns_t& some_columns, int a_coord, double a_delta, double some_values[])
+      {
+         const double* column = some_columns.columns[a_coord];
+         const __m128d delta = _mm_set1_pd(a_delta);
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 2)
+         {
+            const __m128d value = _mm_loadu_pd(some_values + crit);
+            _mm_storeu_pd(some_values + crit, _mm_add_pd(value, _mm_mul_pd(delta, _mm_load_pd(column + crit))));
+         }
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("sse2")
+      position_t sse2_classify(const cylinder_columns_t& some_columns, const double some_values[], double an_inside_limit, double an_outside_limit)
+      {
+         const __m128d sign = _mm_set1_pd(-0.0);
+         const __m128d inside_limit = _mm_set1_pd(an_inside_limit);
+         const __m128d outside_limit = _mm_set1_pd(an_outside_limit);
+         int uncertain = 0;
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 2)
+         {
+            const __m128d value = _mm_andnot_pd(sign, _mm_loadu_pd(some_values + crit));
+            if (_mm_movemask_pd(_mm_cmpgt_pd(value, outside_limit)))
+               return position_t::outside;
+            uncertain |= _mm_movemask_pd(_mm_cmpge_pd(value, inside_limit));
+         }
+         return uncertain ? position_t::uncertain : position_t::inside;
+      }
+
+      template <int DIM>
+      const cylinder_kernel_t sse2_kernel =
+      {
+         "sse2", sse2_evaluate<DIM>, sse2_contains<DIM>, sse2_move<DIM>, sse2_classify<DIM>,
+      };
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // AVX2 kernel, four criteria per instruction.
+
+   namespace
+   {
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      inline __m256d avx2_dot(const cylinder_columns_t& some_columns, const double a_trans_point[], int crit)
+      {
+         __m256d dot_p = _mm256_setzero_pd();
+         for (int dim = 0; dim < dimensions_count<DIM>(some_columns); ++dim)
+            dot_p = _mm256_add_pd(dot_p, _mm256_mul_pd(_mm256_load_pd(some_columns.columns[dim] + crit), _mm256_set1_pd(a_trans_point[dim])));
+         return dot_p;
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      void avx2_evaluate(const cylinder_columns_t& some_columns, const double a_trans_point[], double some_values[])
+      {
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 4)
+            _mm256_storeu_pd(some_values + crit, avx2_dot<DIM>(some_columns, a_trans_point, crit));
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      bool avx2_contains(const cylinder_columns_t& some_columns, const double a_trans_point[], double an_epsilon)
+      {
+         const __m256d sign = _mm256_set1_pd(-0.0);
+         const __m256d one = _mm256_set1_pd(1.0);
+         const __m256d epsilon = _mm256_set1_pd(an_epsilon);
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 4)
+         {
+            const __m256d dot_p = avx2_dot<DIM>(some_columns, a_trans_point, crit);
+            const __m256d ans = _mm256_sub_pd(one, _mm256_andnot_pd(sign, dot_p));
+            if (_mm256_movemask_pd(_mm256_cmp_pd(ans, epsilon, _CMP_LT_OQ)))
+               return false;
+         }
+         return true;
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      void avx2_move(const cylinder_columns_t& some_columns, int a_coord, double a_delta, double some_values[])
+      {
+         const double* column = some_columns.columns[a_coord];
+         const __m256d delta = _mm256_set1_pd(a_delta);
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 4)
+         {
+            const __m256d value = _mm256_loadu_pd(some_values + crit);
+            _mm256_storeu_pd(some_values + crit, _mm256_add_pd(value, _mm256_mul_pd(delta, _mm256_load_pd(column + crit))));
+         }
+      }
+
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      position_t avx2_classify(const cylinder_columns_t& some_columns, const double some_values[], double an_inside_limit, double an_outside_limit)
+      {
+         const __m256d sign = _mm256_set1_pd(-0.0);
+         const __m256d inside_limit = _mm256_set1_pd(an_inside_limit);
+         const __m256d outside_limit = _mm256_set1_pd(an_outside_limit);
+         int uncertain = 0;
+         for (int crit = 0; crit < padded_criteria_count<DIM>(some_columns); crit += 4)
+         {
+            const __m256d value = _mm256_andnot_pd(sign, _mm256_loadu_pd(some_values + crit));
+            if (_mm256_movemask_pd(_mm256_cmp_pd(value, outside_limit, _CMP_GT_OQ)))
+               return position_t::outside;
+            uncertain |= _mm256_movemask_pd(_mm256_cmp_pd(value, inside_limit, _CMP_GE_OQ));
+         }
+         return uncertain ? position_t::uncertain : position_t::inside;
+      }
+
+      template <int DIM>
+      const cylinder_kernel_t avx2_kernel =
+      {
+         "avx2", avx2_evaluate<DIM>, avx2_contains<DIM>, avx2_move<DIM>, avx2_classify<DIM>,
+      };
+   }
+
+#endif
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Kernel selection.
+
+   const cylinder_kernel_t& get_scalar_cylinder_kernel(int a_dimensions_count)
+   {
+      return dispatch_dimension(a_dimensions_count, []<int DIM>() -> const cylinder_kernel_t&
+      {
+         return scalar_kernel<DIM>;
+      });
+   }
+
+   const cylinder_kernel_t* get_sse2_cylinder_kernel(int a_dimensions_count)
+   {
+   #ifdef DAK_QUASITILER_HAS_X86_SIMD
+      return dispatch_dimension(a_dimensions_count, []<int DIM>() -> const cylinder_kernel_t*
+      {
+         return &sse2_kernel<DIM>;
+      });
+   #else
+      return nullptr;
+   #endif
+   }
+
+   const cylinder_kernel_t* get_avx2_cylinder_kernel(int a_dimensions_count)
+   {
+   #ifdef DAK_QUASITILER_HAS_X86_SIMD
+      static const bool is_supported = is_avx2_supported();
+      if (!is_supported)
+         return nullptr;
+
+      return dispatch_dimension(a_dimensions_count, []<int DIM>() -> const cylinder_kernel_t*
+      {
+         return &avx2_kernel<DIM>;
+      });
+   #else
+      return nullptr;
+   #endif
+   }
+
+   const cylinder_kernel_t& get_cylinder_kernel(int a_dimensions_count)
+   {
+      if (auto kernel = get_avx2_cylinder_kernel(a_dimensions_count))
+         return *kernel;
+      if (auto kernel = get_sse2_cylinder_kernel(a_dimensions_count))
+         return *kernel;
+      return get_scalar_cylinder_kernel(a_dimensions_count);
+   }
+}
@@ -1,14 +1,32 @@
 #include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/dimension_dispatch.h>
+#include <dak/quasitiler/parallel.h>
+#include <dak/quasitiler/radix_sort.h>
+#include <dak/quasitiler/vertex_index.h>
 
 #include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
 
 
 namespace dak::quasitiler
 {
    // Receives points, point_reporter_t implementation.
+   void drawing_t::report_bounds(const int some_bounds[2][vertex_t::MAX_DIM], int a_dimensions_count)
+   {
+      my_vertex_storage.set_packing(vertex_packing_t(some_bounds, a_dimensions_count));
+      my_tiling_points.clear();
+   }
+
    void drawing_t::report_point(const vertex_t& a_point)
    {
-      my_vertex_storage.emplace_back(a_point);
+      my_vertex_storage.push_back(a_point);
+   }
+
+   void drawing_t::report_points(std::span<const vertex_t> some_points)
+   {
+      my_vertex_storage.append(some_points);
    }
 
    // The locate_tiles function goes over each vertex in my_vertex_storage,
@@ -23,39 +41,201 @@ namespace dak::quasitiler
 
    bool drawing_t::locate_tiles(interruptor_t& an_interruptor)
    {
-      std::sort(my_vertex_storage.begin(), my_vertex_storage.end());
+      return locate_tiles(an_interruptor, 1);
+   }
 
-      // Go over each vertex and find its neighbors; form the list of tiles accordingly.
+   namespace
+   {
+      // How many vertices a worker thread claims at a time.
+      constexpr size_t LOCATE_BLOCK_SIZE = 16 * 1024;
 
-      const size_t vertex_count = my_vertex_storage.size();
-      for (size_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+      // The tiles of one block of vertices, kept until they can be appended in order.
+      struct block_tiles_t
+      {
+         drawing_t::tile_list_t  tiles[tiling_t::MAX_TILE_COMB];
+      };
+   }
+
+   bool drawing_t::locate_tiles(interruptor_t& an_interruptor, int a_thread_count)
+   {
+      my_locate_stats = locate_stats_t();
+
+      a_thread_count = get_thread_count(a_thread_count);
+
+      const bool is_located = my_vertex_storage.is_packed()
+                            ? locate_tiles(my_vertex_storage.keys(), an_interruptor, a_thread_count)
+                            : locate_tiles(my_vertex_storage.vertices(), an_interruptor, a_thread_count);
+      if (!is_located)
+         return false;
+
+      project_vertices(a_thread_count);
+      order_vertices(a_thread_count);
+      return true;
+   }
+
+   template <class KEY>
+   bool drawing_t::locate_tiles(std::vector<KEY>& some_keys, interruptor_t& an_interruptor, int a_thread_count)
+   {
+      // The neighbor of a vertex along a coordinate.
+      const vertex_packing_t& packing = my_vertex_storage.get_packing();
+      auto step = [&packing](KEY a_key, int a_coord, int a_sign) -> KEY
+      {
+         if constexpr (std::is_same_v<KEY, vertex_t>)
+         {
+            a_key.coords[a_coord] += a_sign;
+            return a_key;
+         }
+         else
+         {
+            return a_sign > 0 ? a_key + packing.unit(a_coord) : a_key - packing.unit(a_coord);
+         }
+      };
+
+      // Locate the tiles of a range of vertices. The neighbor loop
+      // is specialized for the dimension of the tiling.
+      auto locate_range = [&](const auto& is_found, size_t a_begin, size_t an_end, tile_list_t some_tiles[],
+                              locate_stats_t& some_stats, interruptor_t& a_range_interruptor)
+      {
+         return dispatch_dimension(my_tiling->dimensions_count(), [&]<int DIM>()
+         {
+            return locate_tiles<DIM>(some_keys, a_begin, an_end, step, is_found, some_tiles, some_stats, a_range_interruptor);
+         });
+      };
+
+      auto locate = [&](const auto& is_found)
       {
-         vertex_t neighbor = my_vertex_storage[vertex_index];
+         stats_timer_t timer(my_locate_stats.search_seconds);
 
+         const size_t vertex_count = some_keys.size();
+         const size_t block_count = (vertex_count + LOCATE_BLOCK_SIZE - 1) / LOCATE_BLOCK_SIZE;
+         const int thread_count = (int)std::min(size_t(a_thread_count), block_count);
+         if (thread_count <= 1)
+            return locate_range(is_found, 0, vertex_count, my_tile_storage, my_locate_stats, an_interruptor);
+
+         // Each thread keeps its own statistics, merged once all are done.
+         std::vector<block_tiles_t> blocks(block_count);
+         std::vector<locate_stats_t> thread_stats(thread_count);
+
+         const bool is_located = run_ordered(thread_count, block_count, an_interruptor,
+            [&](int a_thread_index, size_t a_block, interruptor_t& a_stop)
+            {
+               const size_t begin = a_block * LOCATE_BLOCK_SIZE;
+               const size_t end = std::min(begin + LOCATE_BLOCK_SIZE, vertex_count);
+               return locate_range(is_found, begin, end, blocks[a_block].tiles, thread_stats[a_thread_index], a_stop);
+            },
+            [&](size_t a_block)
+            {
+               // Append the tiles of the block in order and release their memory.
+               for (int comb = 0; comb < my_tiling->tile_combinations_count(); ++comb)
+               {
+                  tile_list_t& tiles = blocks[a_block].tiles[comb];
+                  my_tile_storage[comb].insert(my_tile_storage[comb].end(), tiles.begin(), tiles.end());
+                  tile_list_t().swap(tiles);
+               }
+            });
+
+         if constexpr (STATS_ENABLED)
+            for (const locate_stats_t& stats : thread_stats)
+               my_locate_stats += stats;
+
+         return is_located;
+      };
+
+      if (my_tile_search == tile_search_t::hashed)
+      {
+         const vertex_index_t index = [&]()
+         {
+            stats_timer_t timer(my_locate_stats.index_seconds);
+            if constexpr (std::is_same_v<KEY, vertex_t>)
+               return vertex_index_t(some_keys, my_tiling->dimensions_count(), a_thread_count);
+            else
+               return vertex_index_t(some_keys, a_thread_count);
+         }();
+         return locate([&index](const KEY& a_key, locate_stats_t&)
+         {
+            return index.contains(a_key);
+         });
+      }
+      else
+      {
+         {
+            stats_timer_t timer(my_locate_stats.index_seconds);
+            if constexpr (std::is_same_v<KEY, vertex_t>)
+               radix_sort(some_keys, my_tiling->dimensions_count(), a_thread_count);
+            else
+               radix_sort(some_keys, packing.key_bits(), a_thread_count);
+         }
+         return locate([&some_keys](const KEY& a_key, locate_stats_t& some_stats)
+         {
+            if constexpr (STATS_ENABLED)
+            {
+               return std::binary_search(some_keys.begin(), some_keys.end(), a_key, [&some_stats](const KEY& a_left, const KEY& a_right)
+               {
+                  ++some_stats.binary_search_probes;
+                  return a_left < a_right;
+               });
+            }
+            else
+            {
+               return std::binary_search(some_keys.begin(), some_keys.end(), a_key);
+            }
+         });
+      }
+   }
+
+   template <int DIM, class KEY, class STEP, class FOUND>
+   bool drawing_t::locate_tiles(const std::vector<KEY>& some_keys, size_t a_begin, size_t an_end, STEP&& step, FOUND&& is_found,
+                                tile_list_t some_tiles[], locate_stats_t& some_stats, interruptor_t& an_interruptor) const
+   {
+      // Directions in which to look for neighbors, in slope order.
+
+      const int dim_count = dimension_count<DIM>(my_tiling->dimensions_count());
+      int gens[vertex_t::MAX_DIM];
+      int signs[vertex_t::MAX_DIM];
+      for (int ind = 0; ind < dim_count; ++ind)
+      {
+         gens[ind] = my_tiling->slope_orders()[ind];
+         signs[ind] = my_tiling->signs()[gens[ind]];
+      }
+
+      // Go over each vertex and find its neighbors; form the list of tiles accordingly.
+
+      for (size_t vertex_index = a_begin; vertex_index < an_end; ++vertex_index)
+      {
          // Initialize the tile search loop.
          int gen0 = -1;
 
          // Check all the neighbors in each direction.
-         for (int ind = 0; ind < my_tiling->dimensions_count(); ++ind)
+         for (int ind = 0; ind < dim_count; ++ind)
          {
             // Compute the next neighbor.
-            int gen1 = my_tiling->slope_orders()[ind];
-            neighbor.coords[gen1] += my_tiling->signs()[gen1];
+            const int gen1 = gens[ind];
+            const KEY neighbor = step(some_keys[vertex_index], gen1, signs[ind]);
 
             // Check if the neighbor in the tiling.
-            const bool found = std::binary_search(my_vertex_storage.begin(), my_vertex_storage.end(), neighbor);
+            const bool found = is_found(neighbor, some_stats);
             if (found)
             {
                if (gen0 >= 0)
+               {
                   // We have a new tile, so store in the appropiate array; we could instead draw the tile at this point.
-                  my_tile_storage[my_tiling->tile_index[gen0][gen1]].emplace_back(vertex_index);
+                  some_tiles[my_tiling->tile_index[gen0][gen1]].emplace_back(vertex_index);
+                  if constexpr (STATS_ENABLED)
+                     ++some_stats.tiles;
+               }
                gen0 = gen1;
             }
 
-            // Get ready for the next neighbour.
-            neighbor.coords[gen1] = my_vertex_storage[vertex_index].coords[gen1];
+            if constexpr (STATS_ENABLED)
+            {
+               ++some_stats.neighbor_lookups;
+               some_stats.neighbors_found += found;
+            }
          }
 
+         if constexpr (STATS_ENABLED)
+            ++some_stats.vertices;
+
          // Check if the user wants to stop right now.
          if (0 == (vertex_index % 100) && an_interruptor.interrupted())
             return false;
@@ -64,6 +244,281 @@ namespace dak::quasitiler
       return true;
    }
 
+   namespace
+   {
+      // The bits of each coordinate of the position of a vertex along a curve.
+      constexpr int CURVE_BITS = 16;
+
+      // Spread the bits of the coordinate to the even bits.
+      uint64_t spread_bits(uint32_t a_coord)
+      {
+         uint64_t bits = a_coord & ((uint32_t(1) << CURVE_BITS) - 1);
+         bits = (bits | (bits << 8)) & 0x00FF00FF;
+         bits = (bits | (bits << 4)) & 0x0F0F0F0F;
+         bits = (bits | (bits << 2)) & 0x33333333;
+         bits = (bits | (bits << 1)) & 0x55555555;
+         return bits;
+      }
+
+      // Interleave the bits of the coordinates, y in the upper bit of each pair.
+      uint64_t morton_key(uint32_t x, uint32_t y)
+      {
+         return spread_bits(x) | (spread_bits(y) << 1);
+      }
+
+      // Steps of the Hilbert curve down the quadrants, four levels at a time.
+      //
+      // Each quadrant reads the lower bits in its own orientation, swapped
+      // and inverted as the quadrants above require. For each orientation and
+      // pair of four bits of the coordinates, the table gives the eight bits
+      // of the distance along the curve, and the orientation after them.
+      struct hilbert_table_t
+      {
+         static constexpr int LEVELS = 4;
+
+         hilbert_table_t()
+         {
+            for (uint32_t orientation = 0; orientation < 4; ++orientation)
+            {
+               for (uint32_t x = 0; x < (1 << LEVELS); ++x)
+               {
+                  for (uint32_t y = 0; y < (1 << LEVELS); ++y)
+                  {
+                     uint32_t is_swapped = orientation & 1;
+                     uint32_t is_inverted = orientation >> 1;
+                     uint32_t distance = 0;
+                     for (int bit = LEVELS - 1; bit >= 0; --bit)
+                     {
+                        const uint32_t bx = (x >> bit) & 1;
+                        const uint32_t by = (y >> bit) & 1;
+                        const uint32_t rx = (is_swapped ? by : bx) ^ is_inverted;
+                        const uint32_t ry = (is_swapped ? bx : by) ^ is_inverted;
+                        distance = (distance << 2) | ((3 * rx) ^ ry);
+
+                        // The lower quadrants turn when in the lower half.
+                        if (ry == 0)
+                        {
+                           is_inverted ^= rx;
+                           is_swapped ^= 1;
+                        }
+                     }
+                     steps[orientation][(x << LEVELS) | y] = uint16_t(distance | ((is_swapped | (is_inverted << 1)) << 8));
+                  }
+               }
+            }
+         }
+
+         uint16_t steps[4][1 << (2 * LEVELS)];
+      };
+
+      // Distance along the Hilbert curve.
+      uint64_t hilbert_key(uint32_t x, uint32_t y)
+      {
+         static const hilbert_table_t table;
+         constexpr int LEVELS = hilbert_table_t::LEVELS;
+         constexpr uint32_t MASK = (uint32_t(1) << LEVELS) - 1;
+
+         uint32_t orientation = 0;
+         uint64_t key = 0;
+         for (int shift = CURVE_BITS - LEVELS; shift >= 0; shift -= LEVELS)
+         {
+            const uint16_t step = table.steps[orientation][(((x >> shift) & MASK) << LEVELS) | ((y >> shift) & MASK)];
+            key = (key << (2 * LEVELS)) | (step & 0xFF);
+            orientation = step >> 8;
+         }
+         return key;
+      }
+   }
+
+   void drawing_t::order_vertices(int a_thread_count)
+   {
+      const size_t vertex_count = my_vertex_storage.size();
+      if (my_vertex_order == vertex_order_t::located || vertex_count < 2 || vertex_count > UINT32_MAX)
+         return;
+
+      // The position of each vertex in the tiling plane, scaled
+      // the same along both axis to the grid of the curve.
+
+      if (my_tiling_points.size() != vertex_count)
+         project_vertices(a_thread_count);
+
+      const std::vector<double>& xs = my_tiling_points.xs;
+      const std::vector<double>& ys = my_tiling_points.ys;
+      const auto [low_x, high_x] = std::minmax_element(xs.begin(), xs.end());
+      const auto [low_y, high_y] = std::minmax_element(ys.begin(), ys.end());
+      const double lows[2] = { *low_x, *low_y };
+      const double highs[2] = { *high_x, *high_y };
+
+      const double extent = std::max(highs[0] - lows[0], highs[1] - lows[1]);
+      const double scale = extent > 0. ? ((uint32_t(1) << CURVE_BITS) - 1) / extent : 0.;
+
+      // Sort the vertices by their distance along the curve, in the upper
+      // bits of the sort keys, keeping their current index in the lower bits.
+
+      int index_bits = 0;
+      while ((uint64_t(1) << index_bits) < vertex_count)
+         ++index_bits;
+
+      std::vector<uint64_t> keys(vertex_count);
+      for (size_t index = 0; index < vertex_count; ++index)
+      {
+         const uint32_t x = uint32_t((xs[index] - lows[0]) * scale);
+         const uint32_t y = uint32_t((ys[index] - lows[1]) * scale);
+         const uint64_t curve_key = (my_vertex_order == vertex_order_t::hilbert) ? hilbert_key(x, y) : morton_key(x, y);
+         keys[index] = (curve_key << index_bits) | index;
+      }
+
+      radix_sort(keys, 2 * CURVE_BITS + index_bits, a_thread_count);
+
+      // Move the vertices and their projected points, and give the tiles
+      // the new index of their vertex.
+
+      const uint64_t index_mask = (uint64_t(1) << index_bits) - 1;
+      std::vector<size_t> new_indexes(vertex_count);
+      for (size_t new_index = 0; new_index < vertex_count; ++new_index)
+         new_indexes[keys[new_index] & index_mask] = new_index;
+
+      if (my_vertex_storage.is_packed())
+      {
+         std::vector<vertex_list_t::key_t>& vertex_keys = my_vertex_storage.keys();
+         std::vector<vertex_list_t::key_t> ordered(vertex_count);
+         for (size_t index = 0; index < vertex_count; ++index)
+            ordered[new_indexes[index]] = vertex_keys[index];
+         vertex_keys.swap(ordered);
+      }
+      else
+      {
+         std::vector<vertex_t>& vertices = my_vertex_storage.vertices();
+         std::vector<vertex_t> ordered(vertex_count);
+         for (size_t index = 0; index < vertex_count; ++index)
+            ordered[new_indexes[index]] = vertices[index];
+         vertices.swap(ordered);
+      }
+
+      {
+         projected_points_t ordered;
+         ordered.resize(vertex_count);
+         for (size_t index = 0; index < vertex_count; ++index)
+         {
+            ordered.xs[new_indexes[index]] = xs[index];
+            ordered.ys[new_indexes[index]] = ys[index];
+         }
+         my_tiling_points = std::move(ordered);
+      }
+
+      // A vertex has at most one tile of each combination, so the tiles are
+      // put back in the order of their vertex by marking the combinations of
+      // the tiles of each vertex.
+
+      static_assert(tiling_t::MAX_TILE_COMB <= 32);
+      std::vector<uint32_t> tile_combs(vertex_count);
+      for (int comb = 0; comb < my_tiling->tile_combinations_count(); ++comb)
+      {
+         for (size_t tile : my_tile_storage[comb])
+            tile_combs[new_indexes[tile]] |= uint32_t(1) << comb;
+         my_tile_storage[comb].clear();
+      }
+
+      for (size_t index = 0; index < vertex_count; ++index)
+         for (uint32_t combs = tile_combs[index]; combs; combs &= combs - 1)
+            my_tile_storage[std::countr_zero(combs)].emplace_back(index);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Projection of the lattice points.
+
+   namespace
+   {
+      // The fewest points worth giving to each thread.
+      constexpr size_t MIN_PROJECT_THREAD_COUNT = 64 * 1024;
+
+      // Project points split in slices between threads. The function
+      // projects the given count of points from the given index.
+      template <class PROJECT>
+      void project_points(size_t a_count, int a_thread_count, PROJECT&& project)
+      {
+         a_thread_count = (int)std::clamp<size_t>(a_count / MIN_PROJECT_THREAD_COUNT, 1, get_thread_count(a_thread_count));
+
+         run_threads(a_thread_count, [&](int a_thread_index)
+         {
+            const size_t begin = a_count * a_thread_index / a_thread_count;
+            const size_t end = a_count * (a_thread_index + 1) / a_thread_count;
+            project(begin, end - begin);
+         });
+      }
+   }
+
+   projection_t drawing_t::get_tiling_projection() const
+   {
+      projection_t projection;
+      projection.dimensions_count = my_tiling->dimensions_count();
+      for (int ind = 0; ind < projection.dimensions_count; ++ind)
+      {
+         projection.x_generator[ind] = my_tiling->generator[0][ind];
+         projection.y_generator[ind] = my_tiling->generator[1][ind];
+      }
+      return projection;
+   }
+
+   projection_t drawing_t::get_orthogonal_projection() const
+   {
+      projection_t projection;
+      projection.dimensions_count = my_tiling->dimensions_count();
+      for (int ind = 0; ind < projection.dimensions_count; ++ind)
+      {
+         projection.x_generator[ind] = my_tiling->generator[tiling_t::TARGET_DIM + 1][ind];
+         projection.y_generator[ind] = my_tiling->generator[tiling_t::TARGET_DIM][ind];
+         projection.offsets[ind] = my_tiling->offset[ind];
+      }
+      return projection;
+   }
+
+   void drawing_t::project_vertices(int a_thread_count)
+   {
+      const size_t vertex_count = my_vertex_storage.size();
+      my_tiling_points.resize(vertex_count);
+
+      const projection_t projection = get_tiling_projection();
+      const projection_kernel_t& kernel = get_projection_kernel(projection.dimensions_count);
+      double* xs = my_tiling_points.xs.data();
+      double* ys = my_tiling_points.ys.data();
+
+      if (my_vertex_storage.is_packed())
+      {
+         const vertex_packing_t& packing = my_vertex_storage.get_packing();
+         const vertex_list_t::key_t* keys = my_vertex_storage.keys().data();
+         project_points(vertex_count, a_thread_count, [&](size_t an_index, size_t a_count)
+         {
+            kernel.project_keys(projection, packing, keys + an_index, a_count, xs + an_index, ys + an_index);
+         });
+      }
+      else
+      {
+         lattice_to_tiling(my_vertex_storage.vertices(), xs, ys, a_thread_count);
+      }
+   }
+
+   void drawing_t::lattice_to_tiling(std::span<const vertex_t> some_lattice_points, double some_xs[], double some_ys[], int a_thread_count) const
+   {
+      const projection_t projection = get_tiling_projection();
+      const projection_kernel_t& kernel = get_projection_kernel(projection.dimensions_count);
+      project_points(some_lattice_points.size(), a_thread_count, [&](size_t an_index, size_t a_count)
+      {
+         kernel.project(projection, some_lattice_points.data() + an_index, a_count, some_xs + an_index, some_ys + an_index);
+      });
+   }
+
+   void drawing_t::lattice_to_orthogonal(std::span<const vertex_t> some_lattice_points, double some_xs[], double some_ys[], int a_thread_count) const
+   {
+      const projection_t projection = get_orthogonal_projection();
+      const projection_kernel_t& kernel = get_projection_kernel(projection.dimensions_count);
+      project_points(some_lattice_points.size(), a_thread_count, [&](size_t an_index, size_t a_count)
+      {
+         kernel.project(projection, some_lattice_points.data() + an_index, a_count, some_xs + an_index, some_ys + an_index);
+      });
+   }
+
    void drawing_t::lattice_to_tiling(const vertex_t& a_lattice_point, tiling_point_t& a_tiling_point) const
    {
       a_tiling_point.x = a_tiling_point.y = 0.0f;
@@ -0,0 +1,229 @@
+#include <dak/quasitiler/drawing_cache.h>
+#include <dak/quasitiler/drawing_file.h>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Drawing key.
+
+   drawing_key_t::drawing_key_t(const tiling_t& a_tiling, const double tiling_bounds[2][tiling_t::MAX_DIM])
+   {
+      const int dim_count = a_tiling.dimensions_count();
+
+      // Adding zero turns negative zeros into positive ones, so equal
+      // parameters always have the same bits.
+      auto add = [this](double a_value) { parameters.emplace_back(a_value + 0.); };
+
+      add(dim_count);
+      for (int plane_dim = 0; plane_dim < tiling_t::TARGET_DIM; ++plane_dim)
+         for (int ind = 0; ind < dim_count; ++ind)
+            add(a_tiling.generator[plane_dim][ind]);
+      for (int ind = 0; ind < dim_count; ++ind)
+         add(a_tiling.offset[ind]);
+      for (int bound = 0; bound < 2; ++bound)
+         for (int plane_dim = 0; plane_dim < tiling_t::TARGET_DIM; ++plane_dim)
+            add(tiling_bounds[bound][plane_dim]);
+
+      // FNV-1a hash of the bits of the parameters.
+      hash = 14695981039346656037ull;
+      for (const double value : parameters)
+      {
+         std::uint64_t bits;
+         std::memcpy(&bits, &value, sizeof(bits));
+         for (int byte = 0; byte < 8; ++byte)
+         {
+            hash ^= (bits >> (byte * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+         }
+      }
+   }
+
+   std::string drawing_key_t::name() const
+   {
+      static constexpr char digits[] = "0123456789abcdef";
+      std::string name(16, '0');
+      for (int digit = 0; digit < 16; ++digit)
+         name[15 - digit] = digits[(hash >> (digit * 4)) & 0xF];
+      return name;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Memory tier.
+
+   size_t drawing_cache_t::get_memory_capacity() const
+   {
+      std::lock_guard lock(my_mutex);
+      return my_memory_capacity;
+   }
+
+   void drawing_cache_t::set_memory_capacity(size_t a_memory_capacity)
+   {
+      std::lock_guard lock(my_mutex);
+      my_memory_capacity = a_memory_capacity;
+      trim_memory();
+   }
+
+   std::filesystem::path drawing_cache_t::get_disk_directory() const
+   {
+      std::lock_guard lock(my_mutex);
+      return my_disk_directory;
+   }
+
+   void drawing_cache_t::set_disk_directory(const std::filesystem::path& a_directory)
+   {
+      std::lock_guard lock(my_mutex);
+      my_disk_directory = a_directory;
+   }
+
+   std::shared_ptr<const drawing_t> drawing_cache_t::find(const drawing_key_t& a_key, const std::shared_ptr<tiling_t>& a_tiling)
+   {
+      std::filesystem::path file_name;
+      {
+         std::lock_guard lock(my_mutex);
+
+         const auto pos = my_entries_by_hash.find(a_key.hash);
+         if (pos != my_entries_by_hash.end() && pos->second->first == a_key)
+         {
+            my_entries.splice(my_entries.begin(), my_entries, pos->second);
+            return pos->second->second;
+         }
+
+         if (my_disk_directory.empty())
+            return nullptr;
+
+         file_name = disk_file_name(a_key);
+      }
+
+      // Load without holding the lock, so that other threads can use the memory tier.
+      std::shared_ptr<const drawing_t> drawing = load(file_name, a_key, a_tiling);
+      if (drawing)
+      {
+         std::lock_guard lock(my_mutex);
+         insert_in_memory(a_key, drawing);
+      }
+      return drawing;
+   }
+
+   void drawing_cache_t::insert(const drawing_key_t& a_key, const std::shared_ptr<const drawing_t>& a_drawing)
+   {
+      std::filesystem::path file_name;
+      {
+         std::lock_guard lock(my_mutex);
+
+         insert_in_memory(a_key, a_drawing);
+
+         // Only one thread writes the file of a key at a time.
+         if (my_disk_directory.empty() || !my_writing_hashes.insert(a_key.hash).second)
+            return;
+
+         file_name = disk_file_name(a_key);
+      }
+
+      // Write without holding the lock, so that other threads can use the memory tier.
+      std::error_code error;
+      std::filesystem::create_directories(file_name.parent_path(), error);
+      write_drawing_file(file_name, *a_drawing);
+
+      std::lock_guard lock(my_mutex);
+      my_writing_hashes.erase(a_key.hash);
+   }
+
+   void drawing_cache_t::clear()
+   {
+      std::lock_guard lock(my_mutex);
+      my_entries_by_hash.clear();
+      my_entries.clear();
+   }
+
+   void drawing_cache_t::insert_in_memory(const drawing_key_t& a_key, const std::shared_ptr<const drawing_t>& a_drawing)
+   {
+      const auto pos = my_entries_by_hash.find(a_key.hash);
+      if (pos != my_entries_by_hash.end())
+      {
+         my_entries.erase(pos->second);
+         my_entries_by_hash.erase(pos);
+      }
+
+      my_entries.emplace_front(a_key, a_drawing);
+      my_entries_by_hash[a_key.hash] = my_entries.begin();
+      trim_memory();
+   }
+
+   void drawing_cache_t::trim_memory()
+   {
+      while (my_entries.size() > my_memory_capacity)
+      {
+         my_entries_by_hash.erase(my_entries.back().first.hash);
+         my_entries.pop_back();
+      }
+   }
+
+   std::filesystem::path drawing_cache_t::disk_file_name(const drawing_key_t& a_key) const
+   {
+      return my_disk_directory / (a_key.name() + ".qtiling");
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Disk tier.
+   //
+   // Each drawing is kept in a drawing file, named after the hash of its key.
+   // The file records the tiling, which is verified against the key, but not
+   // the tiling bounds, which are only verified through the hash.
+
+   std::shared_ptr<drawing_t> drawing_cache_t::load(const std::filesystem::path& a_file_name, const drawing_key_t& a_key, const std::shared_ptr<tiling_t>& a_tiling)
+   {
+      mapped_drawing_t mapped;
+      if (!mapped.open(a_file_name))
+         return nullptr;
+
+      // Verify the tiling in the same order as the key parameters.
+      const drawing_file_header_t& header = mapped.get_header();
+      const int dim_count = header.dimensions_count;
+      if (dim_count != a_tiling->dimensions_count())
+         return nullptr;
+
+      size_t parameter = 0;
+      bool is_same = true;
+      auto verify = [&](double a_value)
+      {
+         is_same = is_same && parameter < a_key.parameters.size() && a_key.parameters[parameter++] == a_value + 0.;
+      };
+      verify(dim_count);
+      for (int plane_dim = 0; plane_dim < tiling_t::TARGET_DIM; ++plane_dim)
+         for (int ind = 0; ind < dim_count; ++ind)
+            verify(header.generator[plane_dim][ind]);
+      for (int ind = 0; ind < dim_count; ++ind)
+         verify(header.offset[ind]);
+      if (!is_same)
+         return nullptr;
+
+      // Copy the vertices and tiles out of the file, as it is.
+      auto drawing = std::make_shared<drawing_t>(a_tiling);
+      const packed_vertex_view_t vertices = mapped.get_vertex_storage();
+      drawing->my_vertex_storage.set_packing(vertices.get_packing());
+      if (vertices.is_packed())
+         drawing->my_vertex_storage.keys().assign(vertices.keys().begin(), vertices.keys().end());
+      else
+         drawing->my_vertex_storage.vertices().assign(vertices.vertices().begin(), vertices.vertices().end());
+
+      for (int comb = 0; comb < mapped.tile_combinations_count(); ++comb)
+      {
+         const std::span<const std::uint64_t> tiles = mapped.get_tile_storage(comb);
+         if (std::any_of(tiles.begin(), tiles.end(), [&vertices](std::uint64_t a_tile) { return a_tile >= vertices.size(); }))
+            return nullptr;
+         drawing->my_tile_storage[comb].assign(tiles.begin(), tiles.end());
+      }
+
+      drawing->project_vertices(1);
+      a_tiling->my_is_generated = true;
+
+      return drawing;
+   }
+}
@@ -0,0 +1,322 @@
+#include <dak/quasitiler/drawing_file.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+#ifdef _WIN32
+   #define WIN32_LEAN_AND_MEAN
+   #include <windows.h>
+#else
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+#endif
+
+
+namespace dak::quasitiler
+{
+   using header_t = drawing_file_header_t;
+
+   // The header is written and mapped as is, so its layout must not change
+   // without changing the version.
+   static_assert(std::is_trivially_copyable_v<header_t>);
+   static_assert(std::is_standard_layout_v<header_t>);
+   static_assert(sizeof(header_t) == 1440);
+   static_assert(sizeof(vertex_t) == 32);
+
+   static std::uint64_t align_section(std::uint64_t an_offset)
+   {
+      return (an_offset + header_t::SECTION_ALIGN - 1) / header_t::SECTION_ALIGN * header_t::SECTION_ALIGN;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Writing.
+
+   bool write_drawing_file(const std::filesystem::path& a_file_name, const drawing_t& a_drawing)
+   {
+      const tiling_t& tiling = *a_drawing.get_tiling();
+      const drawing_t::vertex_list_t& vertices = a_drawing.get_vertex_storage();
+
+      header_t header;
+      std::memcpy(header.magic, header_t::MAGIC, sizeof(header.magic));
+      header.version = header_t::VERSION;
+      header.byte_order = header_t::BYTE_ORDER_MARK;
+      header.header_size = sizeof(header_t);
+
+      header.dimensions_count = tiling.dimensions_count();
+      header.tile_combinations_count = tiling.tile_combinations_count();
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+      {
+         header.tile_generator[comb][0] = tiling.tile_generator[comb][0];
+         header.tile_generator[comb][1] = tiling.tile_generator[comb][1];
+      }
+      for (int ind = 0; ind < tiling.dimensions_count(); ++ind)
+      {
+         header.slope_orders[ind] = tiling.slope_orders()[ind];
+         header.signs[ind] = tiling.signs()[ind];
+         header.offset[ind] = tiling.offset[ind];
+         for (int dim = 0; dim < tiling.dimensions_count(); ++dim)
+            header.generator[dim][ind] = tiling.generator[dim][ind];
+      }
+
+      // Lay out the tables.
+
+      std::uint64_t offset = align_section(sizeof(header_t));
+
+      header.vertex_format = vertices.is_packed() ? header_t::vertex_format_t::packed : header_t::vertex_format_t::full;
+      if (vertices.is_packed())
+         vertices.get_packing().get_bounds(header.packing_bounds);
+      header.vertices.offset = offset;
+      header.vertices.count = vertices.size();
+      offset += vertices.size() * (vertices.is_packed() ? sizeof(std::uint64_t) : sizeof(vertex_t));
+
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+      {
+         offset = align_section(offset);
+         header.tiles[comb].offset = offset;
+         header.tiles[comb].count = a_drawing.get_tile_storage()[comb].size();
+         offset += header.tiles[comb].count * sizeof(std::uint64_t);
+      }
+
+      header.file_size = offset;
+
+      // Write the header and tables, padding each table to its offset.
+      // Write to a temporary file first, so that a file mapped by a reader
+      // is replaced rather than modified.
+
+      std::filesystem::path temp_name = a_file_name;
+      temp_name += ".tmp";
+
+      bool is_written = false;
+      {
+         std::ofstream stream(temp_name, std::ios::binary | std::ios::trunc);
+         if (!stream)
+            return false;
+
+         std::uint64_t position = 0;
+         auto write = [&](const void* some_data, std::uint64_t a_size)
+         {
+            stream.write(static_cast<const char*>(some_data), std::streamsize(a_size));
+            position += a_size;
+         };
+         auto pad_to = [&](std::uint64_t an_offset)
+         {
+            static constexpr char zeros[header_t::SECTION_ALIGN] = { };
+            write(zeros, an_offset - position);
+         };
+
+         write(&header, sizeof(header));
+
+         pad_to(header.vertices.offset);
+         if (vertices.is_packed())
+            write(vertices.keys().data(), vertices.keys().size() * sizeof(std::uint64_t));
+         else
+            write(vertices.vertices().data(), vertices.vertices().size() * sizeof(vertex_t));
+
+         for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+         {
+            pad_to(header.tiles[comb].offset);
+            const drawing_t::tile_list_t& tiles = a_drawing.get_tile_storage()[comb];
+            if constexpr (sizeof(size_t) == sizeof(std::uint64_t))
+            {
+               write(tiles.data(), tiles.size() * sizeof(std::uint64_t));
+            }
+            else
+            {
+               for (const size_t tile : tiles)
+               {
+                  const std::uint64_t index = tile;
+                  write(&index, sizeof(index));
+               }
+            }
+         }
+
+         is_written = bool(stream.flush());
+      }
+
+      std::error_code error;
+      if (is_written)
+         std::filesystem::rename(temp_name, a_file_name, error);
+      if (!is_written || error)
+      {
+         std::filesystem::remove(temp_name, error);
+         return false;
+      }
+
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Mapping.
+
+   mapped_drawing_t::~mapped_drawing_t()
+   {
+      close();
+   }
+
+   bool mapped_drawing_t::open(const std::filesystem::path& a_file_name)
+   {
+      close();
+
+   #ifdef _WIN32
+      HANDLE file = CreateFileW(a_file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE)
+         return false;
+      my_file = file;
+
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(file, &size) || size.QuadPart < LONGLONG(sizeof(header_t)))
+      {
+         close();
+         return false;
+      }
+      my_size = std::uint64_t(size.QuadPart);
+
+      my_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (!my_mapping)
+      {
+         close();
+         return false;
+      }
+
+      my_data = static_cast<const std::uint8_t*>(MapViewOfFile(my_mapping, FILE_MAP_READ, 0, 0, 0));
+   #else
+      const int file = ::open(a_file_name.c_str(), O_RDONLY);
+      if (file < 0)
+         return false;
+
+      struct stat status;
+      if (fstat(file, &status) != 0 || status.st_size < off_t(sizeof(header_t)))
+      {
+         ::close(file);
+         return false;
+      }
+      my_size = std::uint64_t(status.st_size);
+
+      // The mapping stays valid after the file is closed.
+      void* data = mmap(nullptr, my_size, PROT_READ, MAP_SHARED, file, 0);
+      ::close(file);
+      my_data = (data == MAP_FAILED) ? nullptr : static_cast<const std::uint8_t*>(data);
+   #endif
+
+      if (!my_data || !verify())
+      {
+         close();
+         return false;
+      }
+
+      const header_t& header = get_header();
+      if (header.vertex_format == header_t::vertex_format_t::packed)
+      {
+         int bounds[2][vertex_t::MAX_DIM];
+         std::copy(header.packing_bounds[0], header.packing_bounds[0] + vertex_t::MAX_DIM, bounds[0]);
+         std::copy(header.packing_bounds[1], header.packing_bounds[1] + vertex_t::MAX_DIM, bounds[1]);
+         const auto keys = reinterpret_cast<const std::uint64_t*>(my_data + header.vertices.offset);
+         my_vertices = packed_vertex_view_t(vertex_packing_t(bounds, header.dimensions_count), std::span(keys, header.vertices.count));
+      }
+      else
+      {
+         const auto vertices = reinterpret_cast<const vertex_t*>(my_data + header.vertices.offset);
+         my_vertices = packed_vertex_view_t(std::span(vertices, header.vertices.count));
+      }
+
+      return true;
+   }
+
+   void mapped_drawing_t::close()
+   {
+      my_vertices = packed_vertex_view_t();
+
+   #ifdef _WIN32
+      if (my_data)
+         UnmapViewOfFile(my_data);
+      if (my_mapping)
+         CloseHandle(my_mapping);
+      if (my_file)
+         CloseHandle(my_file);
+      my_mapping = nullptr;
+      my_file = nullptr;
+   #else
+      if (my_data)
+         munmap(const_cast<std::uint8_t*>(my_data), my_size);
+   #endif
+
+      my_data = nullptr;
+      my_size = 0;
+   }
+
+   std::span<const std::uint64_t> mapped_drawing_t::get_tile_storage(int a_tile_comb) const
+   {
+      const header_t::section_t& section = get_header().tiles[a_tile_comb];
+      return std::span(reinterpret_cast<const std::uint64_t*>(my_data + section.offset), section.count);
+   }
+
+   bool mapped_drawing_t::verify() const
+   {
+      const header_t& header = get_header();
+
+      if (std::memcmp(header.magic, header_t::MAGIC, sizeof(header.magic)) != 0)
+         return false;
+      if (header.version != header_t::VERSION || header.byte_order != header_t::BYTE_ORDER_MARK)
+         return false;
+      if (header.header_size != sizeof(header_t) || header.file_size != my_size)
+         return false;
+
+      const int dim_count = header.dimensions_count;
+      if (dim_count < 1 || dim_count > header_t::MAX_DIM)
+         return false;
+      if (header.tile_combinations_count != dim_count * (dim_count - 1) / 2)
+         return false;
+
+      // Verify that a table is aligned and within the file.
+      auto is_valid = [this](const header_t::section_t& a_section, std::uint64_t an_element_size)
+      {
+         if (a_section.offset % header_t::SECTION_ALIGN != 0 || a_section.offset < sizeof(header_t) || a_section.offset > my_size)
+            return false;
+         return a_section.count <= (my_size - a_section.offset) / an_element_size;
+      };
+
+      switch (header.vertex_format)
+      {
+         case header_t::vertex_format_t::packed:
+         {
+            if (!is_valid(header.vertices, sizeof(std::uint64_t)))
+               return false;
+
+            // The packing is built from the bounds, which must be ordered,
+            // leave room for the spare value on each side and fit in a key.
+            int bounds[2][vertex_t::MAX_DIM] = { };
+            for (int ind = 0; ind < dim_count; ++ind)
+            {
+               bounds[0][ind] = header.packing_bounds[0][ind];
+               bounds[1][ind] = header.packing_bounds[1][ind];
+               if (bounds[0][ind] > bounds[1][ind])
+                  return false;
+               if (bounds[0][ind] == std::numeric_limits<int>::min() || bounds[1][ind] == std::numeric_limits<int>::max())
+                  return false;
+            }
+            if (!vertex_packing_t(bounds, dim_count).fits())
+               return false;
+            break;
+         }
+         case header_t::vertex_format_t::full:
+            if (!is_valid(header.vertices, sizeof(vertex_t)))
+               return false;
+            break;
+         default:
+            return false;
+      }
+
+      for (int comb = 0; comb < header.tile_combinations_count; ++comb)
+         if (!is_valid(header.tiles[comb], sizeof(std::uint64_t)))
+            return false;
+
+      return true;
+   }
+}
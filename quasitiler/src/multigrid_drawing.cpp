@@ -0,0 +1,284 @@
+#include <dak/quasitiler/multigrid_drawing.h>
+#include <dak/quasitiler/vertex_index.h>
+
+#include <cmath>
+#include <algorithm>
+
+
+namespace dak::quasitiler
+{
+   static constexpr int TARGET_DIM = tiling_t::TARGET_DIM;
+   static constexpr int MAX_DIM = tiling_t::MAX_DIM;
+
+   // A grid line closer than this to an intersection of two others is
+   // considered to go through it, which makes the tiling singular there.
+   static constexpr double SINGULAR_MARGIN = 1e-9;
+
+   // Families of grid lines whose directions are closer than this are
+   // considered parallel, so never intersect.
+   static constexpr double PARALLEL_MARGIN = 1e-12;
+
+   namespace
+   {
+      // The grid line intersections of the tiling within the region, given
+      // the ranges of the lattice coordinates of its plane points. The tiles
+      // are added to the tile storage, their corners to the corner table.
+      //
+      // Returns false when interrupted or, setting is_singular, when three
+      // grid lines meet.
+
+      template <class KEY, class TO_KEY, class STEP>
+      bool intersect_lines(const tiling_t& a_tiling, const double region[2][TARGET_DIM], const double coord_ranges[2][MAX_DIM],
+                           TO_KEY&& to_key, STEP&& step, vertex_table_t<KEY>& corners,
+                           drawing_t::tile_list_t* some_tile_storage, bool& is_singular, interruptor_t& an_interruptor)
+      {
+         const int dim_count = a_tiling.dimensions_count();
+         const double* offset = a_tiling.offset;
+         const double* gens[TARGET_DIM] = { a_tiling.generator[0], a_tiling.generator[1] };
+         const std::vector<int>& signs = a_tiling.signs();
+
+         int slope_positions[MAX_DIM];
+         for (int ind = 0; ind < dim_count; ++ind)
+            slope_positions[a_tiling.slope_orders()[ind]] = ind;
+
+         size_t line_count = 0;
+         for (int gen0 = 0; gen0 < dim_count; ++gen0)
+         {
+            for (int gen1 = gen0 + 1; gen1 < dim_count; ++gen1)
+            {
+               // Along a line of the first family, the second coordinate of the
+               // plane point changes by the determinant per unit of the line parameter.
+
+               const double det = gens[0][gen0] * gens[1][gen1] - gens[1][gen0] * gens[0][gen1];
+               if (std::abs(det) < PARALLEL_MARGIN)
+                  continue;
+
+               // The tile storage is only indexed by generators in slope order.
+               drawing_t::tile_list_t& tile_storage = some_tile_storage[slope_positions[gen0] < slope_positions[gen1]
+                                                                        ? a_tiling.tile_index[gen0][gen1]
+                                                                        : a_tiling.tile_index[gen1][gen0]];
+
+               const double direction[TARGET_DIM] = { -gens[1][gen0], gens[0][gen0] };
+               const double norm_squared = gens[0][gen0] * gens[0][gen0] + gens[1][gen0] * gens[1][gen0];
+
+               double slopes[MAX_DIM];
+               for (int ind = 0; ind < dim_count; ++ind)
+                  slopes[ind] = gens[0][ind] * direction[0] + gens[1][ind] * direction[1];
+
+               const int first_line = (int)std::ceil(coord_ranges[0][gen0] - 0.5);
+               const int last_line = (int)std::floor(coord_ranges[1][gen0] - 0.5);
+               for (int line0 = first_line; line0 <= last_line; ++line0)
+               {
+                  // Check if the user wants to stop right now.
+                  if (0 == (++line_count % 16) && an_interruptor.interrupted())
+                     return false;
+
+                  // The point of the line closest to the origin of the plane.
+
+                  const double distance = (line0 + 0.5 - offset[gen0]) / norm_squared;
+                  const double base[TARGET_DIM] = { gens[0][gen0] * distance, gens[1][gen0] * distance };
+
+                  // Clip the line to the region.
+
+                  double param_min = -HUGE_VAL;
+                  double param_max = HUGE_VAL;
+                  for (int dim = 0; dim < TARGET_DIM; ++dim)
+                  {
+                     if (std::abs(direction[dim]) < PARALLEL_MARGIN)
+                     {
+                        if (base[dim] < region[0][dim] || base[dim] > region[1][dim])
+                           param_max = -HUGE_VAL;
+                        continue;
+                     }
+                     const double low = (region[0][dim] - base[dim]) / direction[dim];
+                     const double high = (region[1][dim] - base[dim]) / direction[dim];
+                     param_min = std::max(param_min, std::min(low, high));
+                     param_max = std::min(param_max, std::max(low, high));
+                  }
+                  if (param_min > param_max)
+                     continue;
+
+                  // The plane point coordinates at the base of the line.
+
+                  double coords[MAX_DIM];
+                  for (int ind = 0; ind < dim_count; ++ind)
+                     coords[ind] = offset[ind] + gens[0][ind] * base[0] + gens[1][ind] * base[1];
+
+                  // Go over the lines of the second family crossing the clipped line.
+
+                  const double cross_start = coords[gen1] + param_min * det;
+                  const double cross_end = coords[gen1] + param_max * det;
+                  const int first_cross = (int)std::ceil(std::min(cross_start, cross_end) - 0.5);
+                  const int last_cross = (int)std::floor(std::max(cross_start, cross_end) - 0.5);
+                  for (int line1 = first_cross; line1 <= last_cross; ++line1)
+                  {
+                     const double param = (line1 + 0.5 - coords[gen1]) / det;
+
+                     // The corner of the tile from which the two generators go,
+                     // in the directions given by their signs. The other
+                     // coordinates are those of the plane point, rounded.
+
+                     vertex_t corner;
+                     for (int ind = 0; ind < dim_count; ++ind)
+                     {
+                        if (ind == gen0 || ind == gen1)
+                           continue;
+
+                        const double coord = coords[ind] + param * slopes[ind] + 0.5;
+                        const double rounded = std::floor(coord);
+                        if (coord - rounded < SINGULAR_MARGIN || rounded + 1. - coord < SINGULAR_MARGIN)
+                        {
+                           is_singular = true;
+                           return false;
+                        }
+                        corner.coords[ind] = (int)rounded;
+                     }
+                     corner.coords[gen0] = signs[gen0] > 0 ? line0 : line0 + 1;
+                     corner.coords[gen1] = signs[gen1] > 0 ? line1 : line1 + 1;
+
+                     const KEY key = to_key(corner);
+                     const KEY key0 = step(key, gen0, signs[gen0]);
+                     const KEY key1 = step(key, gen1, signs[gen1]);
+                     tile_storage.emplace_back(corners.insert(key).first);
+                     corners.insert(key0);
+                     corners.insert(key1);
+                     corners.insert(step(key0, gen1, signs[gen1]));
+                  }
+               }
+            }
+         }
+
+         return true;
+      }
+   }
+
+   bool multigrid_drawing_t::generate(double tiling_bounds[2][tiling_t::MAX_DIM], drawing_t& a_drawing, interruptor_t& an_interruptor)
+   {
+      auto clear = [&a_drawing]()
+      {
+         a_drawing.my_vertex_storage = drawing_t::vertex_list_t();
+         for (auto& tiles : a_drawing.my_tile_storage)
+            tiles.clear();
+      };
+
+      my_used_fallback = false;
+      my_tiling->my_is_generated = false;
+      clear();
+
+      if (intersect_grids(tiling_bounds, a_drawing, an_interruptor))
+      {
+         a_drawing.project_vertices(1);
+         a_drawing.order_vertices(1);
+         my_tiling->my_is_generated = true;
+         return true;
+      }
+
+      if (!my_used_fallback)
+         return false;
+
+      clear();
+      if (!my_tiling->generate(tiling_bounds, a_drawing, an_interruptor))
+         return false;
+      return a_drawing.locate_tiles(an_interruptor);
+   }
+
+   bool multigrid_drawing_t::intersect_grids(double tiling_bounds[2][tiling_t::MAX_DIM], drawing_t& a_drawing, interruptor_t& an_interruptor)
+   {
+      const int dim_count = my_tiling->dimensions_count();
+      const double* offset = my_tiling->offset;
+      const double* gens[TARGET_DIM] = { my_tiling->generator[0], my_tiling->generator[1] };
+
+      // The region containing the intersections of the tiles to generate.
+      // A tile corner differs from the plane point at the intersection by at
+      // most one half along each lattice coordinate, so it is not further
+      // than half the sum of the projected generators from the intersection.
+
+      double region[2][TARGET_DIM];
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+      {
+         double reach = 0.;
+         for (int ind = 0; ind < dim_count; ++ind)
+            reach += std::abs(gens[dim][ind]) * 0.5;
+         region[0][dim] = tiling_bounds[0][dim] - reach;
+         region[1][dim] = tiling_bounds[1][dim] + reach;
+      }
+
+      // The range of each lattice coordinate of the plane points in the region
+      // and the bounds of the lattice points that can be tile corners.
+
+      double coord_ranges[2][MAX_DIM];
+      int bounds[2][MAX_DIM] = { };
+      for (int ind = 0; ind < dim_count; ++ind)
+      {
+         coord_ranges[0][ind] = coord_ranges[1][ind] = offset[ind];
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+         {
+            const double low = gens[dim][ind] * region[0][dim];
+            const double high = gens[dim][ind] * region[1][dim];
+            coord_ranges[0][ind] += std::min(low, high);
+            coord_ranges[1][ind] += std::max(low, high);
+         }
+         bounds[0][ind] = (int)std::floor(coord_ranges[0][ind]) - 1;
+         bounds[1][ind] = (int)std::ceil(coord_ranges[1][ind]) + 1;
+      }
+
+      a_drawing.report_bounds(bounds, dim_count);
+
+      // The distinct corners of the tiles. There are about as many as tiles,
+      // and two families cross as many times per unit area as the
+      // determinant of their projected generators.
+
+      double expected_count = 0.;
+      for (int gen0 = 0; gen0 < dim_count; ++gen0)
+         for (int gen1 = gen0 + 1; gen1 < dim_count; ++gen1)
+            expected_count += std::abs(gens[0][gen0] * gens[1][gen1] - gens[1][gen0] * gens[0][gen1]);
+      expected_count *= (region[1][0] - region[0][0]) * (region[1][1] - region[0][1]);
+      const size_t corner_count = size_t(expected_count * 1.1) + 16;
+
+      // The tiles are intersected with packed keys when the vertices fit.
+
+      bool is_singular = false;
+      drawing_t::vertex_list_t& vertex_storage = a_drawing.my_vertex_storage;
+      if (vertex_storage.is_packed())
+      {
+         const vertex_packing_t& packing = vertex_storage.get_packing();
+         auto to_key = [&packing](const vertex_t& a_vertex)
+         {
+            return packing.pack(a_vertex);
+         };
+         auto step = [&packing](uint64_t a_key, int a_coord, int a_sign)
+         {
+            return a_sign > 0 ? a_key + packing.unit(a_coord) : a_key - packing.unit(a_coord);
+         };
+
+         vertex_table_t<uint64_t> corners(corner_count, dim_count);
+         if (intersect_lines(*my_tiling, region, coord_ranges, to_key, step, corners, a_drawing.my_tile_storage, is_singular, an_interruptor))
+         {
+            vertex_storage.keys() = std::move(corners.keys);
+            return true;
+         }
+      }
+      else
+      {
+         auto to_key = [](const vertex_t& a_vertex)
+         {
+            return a_vertex;
+         };
+         auto step = [](vertex_t a_vertex, int a_coord, int a_sign)
+         {
+            a_vertex.coords[a_coord] += a_sign;
+            return a_vertex;
+         };
+
+         vertex_table_t<vertex_t> corners(corner_count, dim_count);
+         if (intersect_lines(*my_tiling, region, coord_ranges, to_key, step, corners, a_drawing.my_tile_storage, is_singular, an_interruptor))
+         {
+            vertex_storage.vertices() = std::move(corners.keys);
+            return true;
+         }
+      }
+
+      my_used_fallback = is_singular;
+      return false;
+   }
+}
@@ -0,0 +1,121 @@
+#include <dak/quasitiler/packed_vertex.h>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vertex packing.
+
+   vertex_packing_t::vertex_packing_t(const int some_bounds[2][MAX_DIM], int a_dimensions_count)
+      : my_dimensions_count(a_dimensions_count)
+   {
+      // Fill the lanes from the last coordinate, in the least significant bits.
+
+      for (int ind = a_dimensions_count; --ind >= 0; )
+      {
+         my_bounds[0][ind] = some_bounds[0][ind];
+         my_bounds[1][ind] = some_bounds[1][ind];
+
+         // Keep a spare value on each side.
+         my_bases[ind] = some_bounds[0][ind] - 1;
+         const int64_t range = int64_t(some_bounds[1][ind]) - int64_t(some_bounds[0][ind]) + 3;
+
+         int bits = 1;
+         while (bits < 32 && (int64_t(1) << bits) < range)
+            ++bits;
+
+         my_shifts[ind] = my_key_bits;
+         my_key_bits += bits;
+         my_masks[ind] = (key_t(1) << bits) - 1;
+      }
+   }
+
+   void vertex_packing_t::get_bounds(int some_bounds[2][MAX_DIM]) const
+   {
+      for (int ind = 0; ind < MAX_DIM; ++ind)
+      {
+         some_bounds[0][ind] = my_bounds[0][ind];
+         some_bounds[1][ind] = my_bounds[1][ind];
+      }
+   }
+
+   bool vertex_packing_t::contains(const vertex_t& a_vertex) const
+   {
+      for (int ind = 0; ind < my_dimensions_count; ++ind)
+         if (a_vertex.coords[ind] < my_bounds[0][ind] || a_vertex.coords[ind] > my_bounds[1][ind])
+            return false;
+      for (int ind = my_dimensions_count; ind < MAX_DIM; ++ind)
+         if (a_vertex.coords[ind] != 0)
+            return false;
+      return true;
+   }
+
+   vertex_packing_t::key_t vertex_packing_t::pack(const vertex_t& a_vertex) const
+   {
+      key_t key = 0;
+      for (int ind = 0; ind < my_dimensions_count; ++ind)
+         key |= key_t(a_vertex.coords[ind] - my_bases[ind]) << my_shifts[ind];
+      return key;
+   }
+
+   vertex_t vertex_packing_t::unpack(key_t a_key) const
+   {
+      vertex_t vertex;
+      for (int ind = 0; ind < my_dimensions_count; ++ind)
+         vertex.coords[ind] = int((a_key >> my_shifts[ind]) & my_masks[ind]) + my_bases[ind];
+      return vertex;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Packed vertex list.
+
+   void packed_vertex_list_t::set_packing(const vertex_packing_t& a_packing)
+   {
+      unpack_all();
+
+      my_packing = a_packing;
+      if (!my_packing.fits())
+         return;
+
+      for (const vertex_t& vertex : my_vertices)
+         if (!my_packing.contains(vertex))
+            return;
+
+      my_keys.reserve(my_vertices.size());
+      for (const vertex_t& vertex : my_vertices)
+         my_keys.emplace_back(my_packing.pack(vertex));
+      std::vector<vertex_t>().swap(my_vertices);
+      my_is_packed = true;
+   }
+
+   void packed_vertex_list_t::push_back(const vertex_t& a_vertex)
+   {
+      if (my_is_packed && !my_packing.contains(a_vertex))
+         unpack_all();
+
+      if (my_is_packed)
+         my_keys.emplace_back(my_packing.pack(a_vertex));
+      else
+         my_vertices.emplace_back(a_vertex);
+   }
+
+   void packed_vertex_list_t::append(std::span<const vertex_t> some_vertices)
+   {
+      for (const vertex_t& vertex : some_vertices)
+         push_back(vertex);
+   }
+
+   void packed_vertex_list_t::unpack_all()
+   {
+      if (!my_is_packed)
+         return;
+
+      my_vertices.reserve(my_keys.size());
+      for (key_t key : my_keys)
+         my_vertices.emplace_back(my_packing.unpack(key));
+      std::vector<key_t>().swap(my_keys);
+      my_is_packed = false;
+   }
+}
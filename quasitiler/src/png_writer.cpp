@@ -0,0 +1,363 @@
+#include <dak/quasitiler/png_writer.h>
+
+#include <algorithm>
+
+
+namespace dak::quasitiler
+{
+   namespace
+   {
+      ////////////////////////////////////////////////////////////////////////
+      //
+      // Checksums.
+
+      // CRC-32 of the PNG chunks.
+      struct crc_table_t
+      {
+         std::uint32_t values[256];
+
+         crc_table_t()
+         {
+            for (std::uint32_t index = 0; index < 256; ++index)
+            {
+               std::uint32_t value = index;
+               for (int bit = 0; bit < 8; ++bit)
+                  value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : (value >> 1);
+               values[index] = value;
+            }
+         }
+      };
+
+      std::uint32_t update_crc(std::uint32_t a_crc, const std::uint8_t* some_data, size_t a_size)
+      {
+         static const crc_table_t table;
+         for (size_t index = 0; index < a_size; ++index)
+            a_crc = table.values[(a_crc ^ some_data[index]) & 0xFF] ^ (a_crc >> 8);
+         return a_crc;
+      }
+
+      // Adler-32 of the compressed data. The sums are reduced every NMAX
+      // bytes, the most that can be summed without overflowing.
+      void update_adler(std::uint32_t& a, std::uint32_t& b, const std::uint8_t* some_data, size_t a_size)
+      {
+         static constexpr std::uint32_t BASE = 65521;
+         static constexpr size_t NMAX = 5552;
+         while (a_size > 0)
+         {
+            const size_t count = std::min(a_size, NMAX);
+            for (size_t index = 0; index < count; ++index)
+            {
+               a += some_data[index];
+               b += a;
+            }
+            a %= BASE;
+            b %= BASE;
+            some_data += count;
+            a_size -= count;
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      //
+      // Fixed Huffman codes of deflate.
+
+      std::uint32_t reverse_bits(std::uint32_t a_code, int a_bit_count)
+      {
+         std::uint32_t reversed = 0;
+         for (int bit = 0; bit < a_bit_count; ++bit)
+            reversed |= ((a_code >> bit) & 1) << (a_bit_count - 1 - bit);
+         return reversed;
+      }
+
+      // The codes of the literal and length symbols, bit-reversed since
+      // deflate writes the codes from their most significant bit.
+      struct fixed_codes_t
+      {
+         std::uint32_t codes[288];
+         int           bit_counts[288];
+
+         fixed_codes_t()
+         {
+            for (int symbol = 0; symbol < 288; ++symbol)
+            {
+               std::uint32_t code;
+               int bit_count;
+               if (symbol < 144)      { code = 0x30 + symbol;          bit_count = 8; }
+               else if (symbol < 256) { code = 0x190 + symbol - 144;   bit_count = 9; }
+               else if (symbol < 280) { code = symbol - 256;           bit_count = 7; }
+               else                   { code = 0xC0 + symbol - 280;    bit_count = 8; }
+               codes[symbol] = reverse_bits(code, bit_count);
+               bit_counts[symbol] = bit_count;
+            }
+         }
+      };
+
+      const fixed_codes_t& get_fixed_codes()
+      {
+         static const fixed_codes_t codes;
+         return codes;
+      }
+
+      // The symbol and extra bits of each match length.
+      struct length_codes_t
+      {
+         struct code_t
+         {
+            int symbol = 0;
+            int extra_bit_count = 0;
+            int extra = 0;
+         };
+
+         code_t codes[259];
+
+         length_codes_t()
+         {
+            static constexpr int bases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static constexpr int extra_bit_counts[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            for (int index = 0; index < 29; ++index)
+            {
+               const int next_base = (index < 28) ? bases[index + 1] : 259;
+               for (int length = bases[index]; length < next_base; ++length)
+                  codes[length] = code_t{ 257 + index, extra_bit_counts[index], length - bases[index] };
+            }
+         }
+      };
+
+      const length_codes_t& get_length_codes()
+      {
+         static const length_codes_t codes;
+         return codes;
+      }
+
+      static constexpr int MAX_MATCH = 258;
+      static constexpr int MIN_MATCH = 3;
+      static constexpr int END_OF_BLOCK = 256;
+
+      // Compressed data accumulated before being written as a chunk.
+      static constexpr size_t CHUNK_SIZE = 1 << 18;
+
+      void append_u32(std::vector<std::uint8_t>& a_buffer, std::uint32_t a_value)
+      {
+         a_buffer.push_back(std::uint8_t(a_value >> 24));
+         a_buffer.push_back(std::uint8_t(a_value >> 16));
+         a_buffer.push_back(std::uint8_t(a_value >> 8));
+         a_buffer.push_back(std::uint8_t(a_value));
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Image.
+
+   png_writer_t::~png_writer_t()
+   {
+      close();
+   }
+
+   bool png_writer_t::open(const std::filesystem::path& a_file_name, int a_width, int a_height)
+   {
+      close();
+
+      if (a_width <= 0 || a_height <= 0)
+         return false;
+
+      if (!my_writer.open(a_file_name))
+         return false;
+
+      my_width = a_width;
+      my_height = a_height;
+      my_rows_count = 0;
+      my_row.assign(1 + size_t(a_width) * 3, 0);
+      my_compressed.clear();
+      my_compressed.reserve(CHUNK_SIZE + 1024);
+      my_bits = 0;
+      my_bit_count = 0;
+      my_has_previous = false;
+      my_previous = 0;
+      my_run_count = 0;
+      my_adler_a = 1;
+      my_adler_b = 0;
+
+      static constexpr std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+      my_writer.write(std::string_view(reinterpret_cast<const char*>(signature), sizeof(signature)));
+
+      // 8 bits per channel, RGB, deflate, adaptive filtering, no interlace.
+      std::vector<std::uint8_t> header;
+      append_u32(header, std::uint32_t(a_width));
+      append_u32(header, std::uint32_t(a_height));
+      header.insert(header.end(), { 8, 2, 0, 0, 0 });
+      write_chunk("IHDR", header.data(), header.size());
+
+      // The zlib header, then a single final deflate block with fixed codes.
+      my_compressed.push_back(0x78);
+      my_compressed.push_back(0x01);
+      write_bits(1, 1);
+      write_bits(1, 2);
+
+      return true;
+   }
+
+   void png_writer_t::write_row(const std::uint8_t* some_pixels)
+   {
+      if (!is_open() || my_rows_count >= my_height)
+         return;
+      ++my_rows_count;
+
+      // Sub filter: each byte minus the same byte of the pixel to its left.
+      const size_t byte_count = size_t(my_width) * 3;
+      std::uint8_t* row = my_row.data();
+      row[0] = 1;
+      for (size_t index = 0; index < byte_count; ++index)
+         row[1 + index] = std::uint8_t(some_pixels[index] - (index >= 3 ? some_pixels[index - 3] : 0));
+
+      update_adler(my_adler_a, my_adler_b, row, my_row.size());
+
+      // Compress the runs of the same byte.
+      const size_t size = my_row.size();
+      for (size_t index = 0; index < size; )
+      {
+         const std::uint8_t value = row[index];
+         size_t end = index + 1;
+         while (end < size && row[end] == value)
+            ++end;
+         write_run(value, int(end - index));
+         index = end;
+      }
+
+      if (my_compressed.size() >= CHUNK_SIZE)
+         flush_compressed(false);
+   }
+
+   bool png_writer_t::close()
+   {
+      if (!is_open())
+         return false;
+
+      const bool is_complete = (my_rows_count == my_height);
+
+      // Rows not written are left black, so that the file is still valid.
+      if (!is_complete)
+      {
+         const std::vector<std::uint8_t> black(size_t(my_width) * 3, 0);
+         while (my_rows_count < my_height)
+            write_row(black.data());
+      }
+
+      // End the pending run, the block and the last byte.
+      write_run(0, 0);
+      const fixed_codes_t& codes = get_fixed_codes();
+      write_bits(codes.codes[END_OF_BLOCK], codes.bit_counts[END_OF_BLOCK]);
+      if (my_bit_count > 0)
+         write_bits(0, 8 - my_bit_count);
+      flush_compressed(true);
+
+      write_chunk("IEND", nullptr, 0);
+
+      my_row.clear();
+      my_compressed.clear();
+      return my_writer.close() && is_complete;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Compressed stream.
+
+   void png_writer_t::write_run(std::uint8_t a_byte, int a_count)
+   {
+      // Continue the pending run or end it and start a new one with a literal.
+      if (!my_has_previous || a_byte != my_previous || a_count == 0)
+      {
+         if (my_run_count >= MIN_MATCH)
+         {
+            write_match(my_run_count);
+         }
+         else
+         {
+            for (int index = 0; index < my_run_count; ++index)
+               write_literal(my_previous);
+         }
+         my_run_count = 0;
+
+         if (a_count == 0)
+            return;
+
+         write_literal(a_byte);
+         my_previous = a_byte;
+         my_has_previous = true;
+         --a_count;
+      }
+
+      // Repeats are matches at distance one, the longest match possible
+      // written as soon as available.
+      my_run_count += a_count;
+      while (my_run_count >= MAX_MATCH)
+      {
+         write_match(MAX_MATCH);
+         my_run_count -= MAX_MATCH;
+      }
+   }
+
+   void png_writer_t::write_literal(std::uint8_t a_byte)
+   {
+      const fixed_codes_t& codes = get_fixed_codes();
+      write_bits(codes.codes[a_byte], codes.bit_counts[a_byte]);
+   }
+
+   void png_writer_t::write_match(int a_length)
+   {
+      const fixed_codes_t& codes = get_fixed_codes();
+      const length_codes_t::code_t& length = get_length_codes().codes[a_length];
+      write_bits(codes.codes[length.symbol], codes.bit_counts[length.symbol]);
+      if (length.extra_bit_count > 0)
+         write_bits(length.extra, length.extra_bit_count);
+
+      // Distance one is the distance code zero, with five bits and no extra bits.
+      write_bits(0, 5);
+   }
+
+   void png_writer_t::write_bits(std::uint32_t some_bits, int a_bit_count)
+   {
+      my_bits |= some_bits << my_bit_count;
+      my_bit_count += a_bit_count;
+      while (my_bit_count >= 8)
+      {
+         my_compressed.push_back(std::uint8_t(my_bits));
+         my_bits >>= 8;
+         my_bit_count -= 8;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // PNG chunks.
+
+   void png_writer_t::flush_compressed(bool is_last)
+   {
+      if (is_last)
+         append_u32(my_compressed, (my_adler_b << 16) | my_adler_a);
+
+      if (!my_compressed.empty())
+         write_chunk("IDAT", my_compressed.data(), my_compressed.size());
+      my_compressed.clear();
+   }
+
+   void png_writer_t::write_chunk(const char a_type[4], const std::uint8_t* some_data, size_t a_size)
+   {
+      std::vector<std::uint8_t> header;
+      append_u32(header, std::uint32_t(a_size));
+      header.insert(header.end(), a_type, a_type + 4);
+
+      std::uint32_t crc = update_crc(0xFFFFFFFFu, header.data() + 4, 4);
+      crc = update_crc(crc, some_data, a_size) ^ 0xFFFFFFFFu;
+
+      std::vector<std::uint8_t> footer;
+      append_u32(footer, crc);
+
+      std::string& out = my_writer.buffer();
+      out.append(reinterpret_cast<const char*>(header.data()), header.size());
+      if (a_size > 0)
+         out.append(reinterpret_cast<const char*>(some_data), a_size);
+      out.append(reinterpret_cast<const char*>(footer.data()), footer.size());
+      my_writer.commit();
+   }
+}
@@ -0,0 +1,161 @@
+#include <dak/quasitiler/projection_kernel.h>
+#include <dak/quasitiler/cpu_features.h>
+#include <dak/quasitiler/dimension_dispatch.h>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Scalar kernel.
+
+   namespace
+   {
+      template <int DIM>
+      inline void scalar_project_point(const projection_t& a_projection, const vertex_t& a_point, double& an_x, double& an_y)
+      {
+         double x = 0.0;
+         double y = 0.0;
+         for (int dim = 0; dim < dimension_count<DIM>(a_projection.dimensions_count); ++dim)
+         {
+            const double coord = a_point.coords[dim] - a_projection.offsets[dim];
+            x += coord * a_projection.x_generator[dim];
+            y += coord * a_projection.y_generator[dim];
+         }
+         an_x = x;
+         an_y = y;
+      }
+
+      template <int DIM>
+      void scalar_project(const projection_t& a_projection, const vertex_t some_points[], size_t a_count, double some_xs[], double some_ys[])
+      {
+         for (size_t index = 0; index < a_count; ++index)
+            scalar_project_point<DIM>(a_projection, some_points[index], some_xs[index], some_ys[index]);
+      }
+
+      template <int DIM>
+      void scalar_project_keys(const projection_t& a_projection, const vertex_packing_t& a_packing, const vertex_packing_t::key_t some_keys[],
+                               size_t a_count, double some_xs[], double some_ys[])
+      {
+         for (size_t index = 0; index < a_count; ++index)
+            scalar_project_point<DIM>(a_projection, a_packing.unpack(some_keys[index]), some_xs[index], some_ys[index]);
+      }
+
+      template <int DIM>
+      const projection_kernel_t scalar_kernel =
+      {
+         "scalar", scalar_project<DIM>, scalar_project_keys<DIM>,
+      };
+   }
+
+#ifdef DAK_QUASITILER_HAS_X86_SIMD
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // AVX2 kernel, four points per instruction. The coordinates of the four
+   // points are gathered from the vertices, one coordinate at a time.
+
+   namespace
+   {
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      void avx2_project(const projection_t& a_projection, const vertex_t some_points[], size_t a_count, double some_xs[], double some_ys[])
+      {
+         const __m128i strides = _mm_setr_epi32(0, vertex_t::MAX_DIM, 2 * vertex_t::MAX_DIM, 3 * vertex_t::MAX_DIM);
+
+         size_t index = 0;
+         for (; index + 4 <= a_count; index += 4)
+         {
+            __m256d x = _mm256_setzero_pd();
+            __m256d y = _mm256_setzero_pd();
+            for (int dim = 0; dim < dimension_count<DIM>(a_projection.dimensions_count); ++dim)
+            {
+               const __m128i coords = _mm_i32gather_epi32(some_points[index].coords + dim, strides, sizeof(int));
+               const __m256d coord = _mm256_sub_pd(_mm256_cvtepi32_pd(coords), _mm256_set1_pd(a_projection.offsets[dim]));
+               x = _mm256_add_pd(x, _mm256_mul_pd(coord, _mm256_set1_pd(a_projection.x_generator[dim])));
+               y = _mm256_add_pd(y, _mm256_mul_pd(coord, _mm256_set1_pd(a_projection.y_generator[dim])));
+            }
+            _mm256_storeu_pd(some_xs + index, x);
+            _mm256_storeu_pd(some_ys + index, y);
+         }
+
+         for (; index < a_count; ++index)
+            scalar_project_point<DIM>(a_projection, some_points[index], some_xs[index], some_ys[index]);
+      }
+
+      // The lanes of four keys are unpacked together, in 64 bits, and the low
+      // 32 bits of each, which hold the whole coordinate, are then converted.
+      template <int DIM>
+      DAK_QUASITILER_TARGET("avx2")
+      void avx2_project_keys(const projection_t& a_projection, const vertex_packing_t& a_packing, const vertex_packing_t::key_t some_keys[],
+                             size_t a_count, double some_xs[], double some_ys[])
+      {
+         const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+         size_t index = 0;
+         for (; index + 4 <= a_count; index += 4)
+         {
+            const __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(some_keys + index));
+            __m256d x = _mm256_setzero_pd();
+            __m256d y = _mm256_setzero_pd();
+            for (int dim = 0; dim < dimension_count<DIM>(a_projection.dimensions_count); ++dim)
+            {
+               const __m256i lane = _mm256_and_si256(_mm256_srl_epi64(keys, _mm_cvtsi32_si128(a_packing.lane_shift(dim))),
+                                                     _mm256_set1_epi64x(int64_t(a_packing.lane_mask(dim))));
+               const __m256i coords = _mm256_permutevar8x32_epi32(_mm256_add_epi64(lane, _mm256_set1_epi64x(a_packing.lane_base(dim))), low_halves);
+               const __m256d coord = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(coords)), _mm256_set1_pd(a_projection.offsets[dim]));
+               x = _mm256_add_pd(x, _mm256_mul_pd(coord, _mm256_set1_pd(a_projection.x_generator[dim])));
+               y = _mm256_add_pd(y, _mm256_mul_pd(coord, _mm256_set1_pd(a_projection.y_generator[dim])));
+            }
+            _mm256_storeu_pd(some_xs + index, x);
+            _mm256_storeu_pd(some_ys + index, y);
+         }
+
+         for (; index < a_count; ++index)
+            scalar_project_point<DIM>(a_projection, a_packing.unpack(some_keys[index]), some_xs[index], some_ys[index]);
+      }
+
+      template <int DIM>
+      const projection_kernel_t avx2_kernel =
+      {
+         "avx2", avx2_project<DIM>, avx2_project_keys<DIM>,
+      };
+   }
+
+#endif
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Kernel selection.
+
+   const projection_kernel_t& get_scalar_projection_kernel(int a_dimensions_count)
+   {
+      return dispatch_dimension(a_dimensions_count, []<int DIM>() -> const projection_kernel_t&
+      {
+         return scalar_kernel<DIM>;
+      });
+   }
+
+   const projection_kernel_t* get_avx2_projection_kernel(int a_dimensions_count)
+   {
+   #ifdef DAK_QUASITILER_HAS_X86_SIMD
+      static const bool is_supported = is_avx2_supported();
+      if (!is_supported)
+         return nullptr;
+
+      return dispatch_dimension(a_dimensions_count, []<int DIM>() -> const projection_kernel_t*
+      {
+         return &avx2_kernel<DIM>;
+      });
+   #else
+      return nullptr;
+   #endif
+   }
+
+   const projection_kernel_t& get_projection_kernel(int a_dimensions_count)
+   {
+      if (auto kernel = get_avx2_projection_kernel(a_dimensions_count))
+         return *kernel;
+      return get_scalar_projection_kernel(a_dimensions_count);
+   }
+}
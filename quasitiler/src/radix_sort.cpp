@@ -0,0 +1,169 @@
+#include <dak/quasitiler/radix_sort.h>
+#include <dak/quasitiler/parallel.h>
+
+#include <algorithm>
+
+
+namespace dak::quasitiler
+{
+   // The most bits sorted by one pass, so that the counts stay in the cache.
+   static constexpr int MAX_DIGIT_BITS = 11;
+
+   // Below this many values, a comparison sort is faster than the passes.
+   static constexpr size_t MIN_RADIX_COUNT = 256;
+
+   // The fewest values worth giving to each thread.
+   static constexpr size_t MIN_THREAD_COUNT = 64 * 1024;
+
+   namespace
+   {
+      // The bits of a value sorted by one pass.
+      struct digit_t
+      {
+         int coord = 0;
+         int shift = 0;
+         int bits = 0;
+      };
+
+      // Split the bits of a value in as few passes as possible of about the same size.
+      void add_digits(std::vector<digit_t>& some_digits, int a_coord, int a_bits)
+      {
+         const int pass_count = (a_bits + MAX_DIGIT_BITS - 1) / MAX_DIGIT_BITS;
+         for (int pass = 0, shift = 0; pass < pass_count; ++pass)
+         {
+            const int bits = (a_bits - shift) / (pass_count - pass);
+            some_digits.push_back({ a_coord, shift, bits });
+            shift += bits;
+         }
+      }
+
+      // Move the values to the other buffer in the order of their digit,
+      // keeping the order of the values with the same digit. Returns false
+      // without moving anything when all the values have the same digit.
+      template <class T, class DIGIT>
+      bool sort_pass(const std::vector<T>& some_values, std::vector<T>& some_sorted, int a_bits, int a_thread_count, DIGIT&& digit_of)
+      {
+         const size_t count = some_values.size();
+         const size_t bucket_count = size_t(1) << a_bits;
+         auto slice_start = [&](int a_thread_index) { return count * a_thread_index / a_thread_count; };
+
+         // Count the digits of each slice.
+
+         std::vector<size_t> offsets(a_thread_count * bucket_count);
+         run_threads(a_thread_count, [&](int a_thread_index)
+         {
+            size_t* counts = offsets.data() + a_thread_index * bucket_count;
+            const size_t end = slice_start(a_thread_index + 1);
+            for (size_t index = slice_start(a_thread_index); index < end; ++index)
+               ++counts[digit_of(some_values[index])];
+         });
+
+         // Each slice puts its values of a digit after those of the previous slices.
+
+         size_t offset = 0;
+         for (size_t bucket = 0; bucket < bucket_count; ++bucket)
+         {
+            const size_t bucket_start = offset;
+            for (int thread_index = 0; thread_index < a_thread_count; ++thread_index)
+            {
+               const size_t bucket_size = offsets[thread_index * bucket_count + bucket];
+               offsets[thread_index * bucket_count + bucket] = offset;
+               offset += bucket_size;
+            }
+            if (offset - bucket_start == count)
+               return false;
+         }
+
+         run_threads(a_thread_count, [&](int a_thread_index)
+         {
+            size_t* starts = offsets.data() + a_thread_index * bucket_count;
+            const size_t end = slice_start(a_thread_index + 1);
+            for (size_t index = slice_start(a_thread_index); index < end; ++index)
+               some_sorted[starts[digit_of(some_values[index])]++] = some_values[index];
+         });
+
+         return true;
+      }
+
+      // Sort the values with one pass per digit, from the least significant.
+      template <class T, class DIGIT>
+      void sort_digits(std::vector<T>& some_values, const std::vector<digit_t>& some_digits, int a_thread_count, DIGIT&& digit_of)
+      {
+         a_thread_count = (int)std::clamp<size_t>(some_values.size() / MIN_THREAD_COUNT, 1, get_thread_count(a_thread_count));
+
+         std::vector<T> sorted(some_values.size());
+         for (const digit_t& digit : some_digits)
+         {
+            const bool is_moved = sort_pass(some_values, sorted, digit.bits, a_thread_count, [&digit, &digit_of](const T& a_value)
+            {
+               return digit_of(a_value, digit);
+            });
+            if (is_moved)
+               some_values.swap(sorted);
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Sorts.
+
+   void radix_sort(std::vector<uint64_t>& some_keys, int a_key_bits, int a_thread_count)
+   {
+      if (some_keys.size() < MIN_RADIX_COUNT || a_key_bits <= 0 || a_key_bits > 64)
+      {
+         std::sort(some_keys.begin(), some_keys.end());
+         return;
+      }
+
+      std::vector<digit_t> digits;
+      add_digits(digits, 0, a_key_bits);
+
+      sort_digits(some_keys, digits, a_thread_count, [](uint64_t a_key, const digit_t& a_digit)
+      {
+         return size_t((a_key >> a_digit.shift) & ((uint64_t(1) << a_digit.bits) - 1));
+      });
+   }
+
+   void radix_sort(std::vector<vertex_t>& some_vertices, int a_dimensions_count, int a_thread_count)
+   {
+      if (some_vertices.size() < MIN_RADIX_COUNT)
+      {
+         std::sort(some_vertices.begin(), some_vertices.end());
+         return;
+      }
+
+      // The range of each coordinate among the vertices.
+
+      int lows[vertex_t::MAX_DIM];
+      int highs[vertex_t::MAX_DIM];
+      for (int ind = 0; ind < a_dimensions_count; ++ind)
+         lows[ind] = highs[ind] = some_vertices[0].coords[ind];
+      for (const vertex_t& vertex : some_vertices)
+      {
+         for (int ind = 0; ind < a_dimensions_count; ++ind)
+         {
+            lows[ind] = std::min(lows[ind], vertex.coords[ind]);
+            highs[ind] = std::max(highs[ind], vertex.coords[ind]);
+         }
+      }
+
+      // The last coordinate is the least significant.
+
+      std::vector<digit_t> digits;
+      for (int ind = a_dimensions_count; --ind >= 0; )
+      {
+         const uint64_t range = uint64_t(int64_t(highs[ind]) - int64_t(lows[ind]));
+         int bits = 0;
+         while (bits < 64 && (range >> bits) != 0)
+            ++bits;
+         add_digits(digits, ind, bits);
+      }
+
+      sort_digits(some_vertices, digits, a_thread_count, [&lows](const vertex_t& a_vertex, const digit_t& a_digit)
+      {
+         const uint64_t value = uint64_t(int64_t(a_vertex.coords[a_digit.coord]) - int64_t(lows[a_digit.coord]));
+         return size_t((value >> a_digit.shift) & ((uint64_t(1) << a_digit.bits) - 1));
+      });
+   }
+}
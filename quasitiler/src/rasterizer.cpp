@@ -0,0 +1,380 @@
+#include <dak/quasitiler/rasterizer.h>
+#include <dak/quasitiler/parallel.h>
+#include <dak/quasitiler/png_writer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace dak::quasitiler
+{
+   namespace
+   {
+      struct pixel_point_t
+      {
+         double x = 0.;
+         double y = 0.;
+      };
+
+      // A tile binned to a band.
+      struct tile_ref_t
+      {
+         int      comb = 0;
+         size_t   vertex_index = 0;
+      };
+
+      // Number of horizontal samples per pixel row.
+      int get_samples_count(const raster_style_t& a_style)
+      {
+         return a_style.antialias ? 4 : 1;
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      //
+      // One band of the image.
+      //
+      // The tiles are accumulated as color times coverage, so that tiles
+      // sharing an edge add up to full coverage without the background
+      // showing through, whatever their order. The edges keep the largest
+      // coverage of any edge, so edges drawn by both of their tiles are not
+      // darker.
+
+      struct band_t
+      {
+         band_t(int a_width, int a_height, const raster_style_t& a_style)
+            : width(a_width), height(a_height), samples_count(get_samples_count(a_style))
+            , colors(size_t(a_width) * a_height * 4), edges(size_t(a_width) * a_height)
+         {
+         }
+
+         // Clear the band to draw the given rows of the image.
+         void reset(int a_first_row, int a_rows_count)
+         {
+            first_row = a_first_row;
+            rows_count = a_rows_count;
+            std::fill(colors.begin(), colors.end(), 0.f);
+            std::fill(edges.begin(), edges.end(), 0.f);
+         }
+
+         // Call the function with each pixel covered by the convex polygon,
+         // as its row in the band and column, and its coverage.
+         template <class COVER>
+         void cover_polygon(const pixel_point_t* some_points, int a_points_count, COVER&& cover) const
+         {
+            double min_y = some_points[0].y;
+            double max_y = some_points[0].y;
+            for (int ind = 1; ind < a_points_count; ++ind)
+            {
+               min_y = std::min(min_y, some_points[ind].y);
+               max_y = std::max(max_y, some_points[ind].y);
+            }
+
+            const int first = std::max(first_row, int(std::floor(min_y)));
+            const int last = std::min(first_row + rows_count - 1, int(std::floor(max_y)));
+            const float weight = 1.f / samples_count;
+
+            for (int row = first; row <= last; ++row)
+            {
+               const int band_row = row - first_row;
+               for (int sample = 0; sample < samples_count; ++sample)
+               {
+                  // The span of the polygon at the height of the sample.
+                  const double y = row + (sample + 0.5) / samples_count;
+                  double left = 1e300;
+                  double right = -1e300;
+                  for (int ind = 0; ind < a_points_count; ++ind)
+                  {
+                     const pixel_point_t& p0 = some_points[ind];
+                     const pixel_point_t& p1 = some_points[(ind + 1) % a_points_count];
+                     if ((p0.y <= y && y < p1.y) || (p1.y <= y && y < p0.y))
+                     {
+                        const double x = p0.x + (y - p0.y) * (p1.x - p0.x) / (p1.y - p0.y);
+                        left = std::min(left, x);
+                        right = std::max(right, x);
+                     }
+                  }
+                  if (left >= right)
+                     continue;
+
+                  if (samples_count == 1)
+                  {
+                     // The pixels whose center is within the span.
+                     const int first_x = std::max(0, int(std::ceil(left - 0.5)));
+                     const int end_x = std::min(width, int(std::ceil(right - 0.5)));
+                     for (int x = first_x; x < end_x; ++x)
+                        cover(band_row, x, 1.f);
+                  }
+                  else
+                  {
+                     // The part of each pixel within the span.
+                     const int first_x = std::max(0, int(std::floor(left)));
+                     const int last_x = std::min(width - 1, int(std::floor(right)));
+                     for (int x = first_x; x <= last_x; ++x)
+                     {
+                        const double covered = std::min(right, x + 1.) - std::max(left, double(x));
+                        cover(band_row, x, weight * float(covered));
+                     }
+                  }
+               }
+            }
+         }
+
+         void fill_polygon(const pixel_point_t* some_points, int a_points_count, const float a_color[3])
+         {
+            cover_polygon(some_points, a_points_count, [&](int a_row, int a_column, float a_coverage)
+            {
+               float* pixel = &colors[(size_t(a_row) * width + a_column) * 4];
+               pixel[0] += a_color[0] * a_coverage;
+               pixel[1] += a_color[1] * a_coverage;
+               pixel[2] += a_color[2] * a_coverage;
+               pixel[3] += a_coverage;
+            });
+         }
+
+         void stroke_edge(const pixel_point_t& a_from, const pixel_point_t& a_to, double a_thickness)
+         {
+            const double dx = a_to.x - a_from.x;
+            const double dy = a_to.y - a_from.y;
+            const double length = std::sqrt(dx * dx + dy * dy);
+            if (length <= 0.)
+               return;
+
+            const double nx = -dy / length * a_thickness / 2.;
+            const double ny = dx / length * a_thickness / 2.;
+            const pixel_point_t quad[4] =
+            {
+               { a_from.x + nx, a_from.y + ny },
+               { a_to.x + nx, a_to.y + ny },
+               { a_to.x - nx, a_to.y - ny },
+               { a_from.x - nx, a_from.y - ny },
+            };
+
+            // The samples of a pixel are summed before keeping the largest
+            // coverage, in a scratch area covering the edge.
+            double min_x = quad[0].x, max_x = quad[0].x, min_y = quad[0].y, max_y = quad[0].y;
+            for (const pixel_point_t& corner : quad)
+            {
+               min_x = std::min(min_x, corner.x);
+               max_x = std::max(max_x, corner.x);
+               min_y = std::min(min_y, corner.y);
+               max_y = std::max(max_y, corner.y);
+            }
+            const int first_x = std::max(0, int(std::floor(min_x)));
+            const int last_x = std::min(width - 1, int(std::floor(max_x)));
+            const int first_y = std::max(first_row, int(std::floor(min_y)));
+            const int last_y = std::min(first_row + rows_count - 1, int(std::floor(max_y)));
+            if (first_x > last_x || first_y > last_y)
+               return;
+
+            const size_t scratch_width = size_t(last_x - first_x + 1);
+            edge_scratch.assign(scratch_width * (last_y - first_y + 1), 0.f);
+            cover_polygon(quad, 4, [&](int a_row, int a_column, float a_coverage)
+            {
+               edge_scratch[size_t(a_row + first_row - first_y) * scratch_width + (a_column - first_x)] += a_coverage;
+            });
+
+            for (int y = first_y; y <= last_y; ++y)
+            {
+               const float* scratch = &edge_scratch[size_t(y - first_y) * scratch_width];
+               float* pixels = &edges[size_t(y - first_row) * width + first_x];
+               for (size_t x = 0; x < scratch_width; ++x)
+                  pixels[x] = std::max(pixels[x], std::min(scratch[x], 1.f));
+            }
+         }
+
+         // Combine the tiles, background and edges into RGB pixels.
+         void resolve(const raster_style_t& a_style, std::uint8_t* some_pixels) const
+         {
+            auto channel = [](std::uint32_t a_color, int a_shift) { return float((a_color >> a_shift) & 0xFF); };
+            const float background[3] = { channel(a_style.background_color, 16), channel(a_style.background_color, 8), channel(a_style.background_color, 0) };
+            const float edge_color[3] = { channel(a_style.edge_color, 16), channel(a_style.edge_color, 8), channel(a_style.edge_color, 0) };
+            const float edge_opacity = float(a_style.edge_opacity);
+
+            const size_t pixels_count = size_t(width) * rows_count;
+            for (size_t index = 0; index < pixels_count; ++index)
+            {
+               const float* pixel = &colors[index * 4];
+               const float coverage = pixel[3];
+               const float scale = coverage > 1.f ? 1.f / coverage : 1.f;
+               const float uncovered = std::max(0.f, 1.f - coverage);
+               const float edge = edges[index] * edge_opacity;
+               for (int c = 0; c < 3; ++c)
+               {
+                  const float fill = pixel[c] * scale + background[c] * uncovered;
+                  const float value = fill * (1.f - edge) + edge_color[c] * edge;
+                  some_pixels[index * 3 + c] = std::uint8_t(std::clamp(value + 0.5f, 0.f, 255.f));
+               }
+            }
+         }
+
+         const int            width;
+         const int            height;
+         const int            samples_count;
+         int                  first_row = 0;
+         int                  rows_count = 0;
+         std::vector<float>   colors;
+         std::vector<float>   edges;
+         std::vector<float>   edge_scratch;
+      };
+   }
+
+   bool write_png_file(const std::filesystem::path& a_file_name, const drawing_t& a_drawing,
+                       const double tiling_bounds[2][tiling_t::MAX_DIM], const raster_style_t& a_style,
+                       int a_thread_count)
+   {
+      const tiling_t& tiling = *a_drawing.get_tiling();
+      const double tile_size = a_style.tile_size;
+      const int width = std::max(1, int(std::ceil((tiling_bounds[1][0] - tiling_bounds[0][0]) * tile_size)));
+      const int height = std::max(1, int(std::ceil((tiling_bounds[1][1] - tiling_bounds[0][1]) * tile_size)));
+      const int band_height = std::max(1, a_style.band_height);
+      const int bands_count = (height + band_height - 1) / band_height;
+
+      // Project the vertices in pixels.
+
+      const drawing_t::vertex_list_t& vertices = a_drawing.get_vertex_storage();
+      std::vector<pixel_point_t> points(vertices.size());
+      for (size_t index = 0; index < vertices.size(); ++index)
+      {
+         tiling_point_t point;
+         a_drawing.lattice_to_tiling(vertices[index], point);
+         points[index].x = (point.x - tiling_bounds[0][0]) * tile_size;
+         points[index].y = (point.y - tiling_bounds[0][1]) * tile_size;
+      }
+
+      // Premultiply the edge generators by their correct sign, in pixels.
+
+      pixel_point_t generator[tiling_t::MAX_DIM];
+      for (int ind = 0; ind < tiling.dimensions_count(); ++ind)
+      {
+         generator[ind].x = tiling.signs()[ind] * tiling.generator[0][ind] * tile_size;
+         generator[ind].y = tiling.signs()[ind] * tiling.generator[1][ind] * tile_size;
+      }
+
+      auto get_corners = [&](const tile_ref_t& a_tile, pixel_point_t some_corners[4])
+      {
+         const pixel_point_t& origin = points[a_tile.vertex_index];
+         const pixel_point_t& gen0 = generator[tiling.tile_generator[a_tile.comb][0]];
+         const pixel_point_t& gen1 = generator[tiling.tile_generator[a_tile.comb][1]];
+         some_corners[0] = origin;
+         some_corners[1] = { origin.x + gen0.x, origin.y + gen0.y };
+         some_corners[2] = { origin.x + gen0.x + gen1.x, origin.y + gen0.y + gen1.y };
+         some_corners[3] = { origin.x + gen1.x, origin.y + gen1.y };
+      };
+
+      // Bin the tiles to the bands they touch: count them, then place them.
+
+      const double margin = a_style.edge_thickness / 2. + 1.;
+      std::vector<size_t> band_starts(bands_count + 1, 0);
+      std::vector<tile_ref_t> binned;
+      for (int pass = 0; pass < 2; ++pass)
+      {
+         std::vector<size_t> band_ends(band_starts.begin(), band_starts.end() - 1);
+         for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+         {
+            for (const size_t vertex_index : a_drawing.get_tile_storage()[comb])
+            {
+               const tile_ref_t tile{ comb, vertex_index };
+               pixel_point_t corners[4];
+               get_corners(tile, corners);
+
+               double min_x = corners[0].x, max_x = corners[0].x;
+               double min_y = corners[0].y, max_y = corners[0].y;
+               for (const pixel_point_t& corner : corners)
+               {
+                  min_x = std::min(min_x, corner.x);
+                  max_x = std::max(max_x, corner.x);
+                  min_y = std::min(min_y, corner.y);
+                  max_y = std::max(max_y, corner.y);
+               }
+               if (max_x + margin < 0. || min_x - margin > width || max_y + margin < 0. || min_y - margin > height)
+                  continue;
+
+               const int first_band = std::max(0, int(std::floor((min_y - margin) / band_height)));
+               const int last_band = std::min(bands_count - 1, int(std::floor((max_y + margin) / band_height)));
+               for (int band = first_band; band <= last_band; ++band)
+               {
+                  if (pass == 0)
+                     ++band_starts[band + 1];
+                  else
+                     binned[band_ends[band]++] = tile;
+               }
+            }
+         }
+
+         if (pass == 0)
+         {
+            for (int band = 0; band < bands_count; ++band)
+               band_starts[band + 1] += band_starts[band];
+            binned.resize(band_starts[bands_count]);
+         }
+      }
+
+      // Colors of the tile combinations.
+
+      std::uint32_t tile_colors[tiling_t::MAX_TILE_COMB];
+      interpolate_tile_colors(tiling.dimensions_count(), a_style.tile_group_colors, tile_colors);
+      float colors[tiling_t::MAX_TILE_COMB][3];
+      for (int comb = 0; comb < tiling_t::MAX_TILE_COMB; ++comb)
+         for (int c = 0; c < 3; ++c)
+            colors[comb][c] = float((tile_colors[comb] >> (16 - 8 * c)) & 0xFF);
+
+      // Draw the bands on the threads and write them in order as they are
+      // done. Each thread draws in its own band buffer, and the pixels of a
+      // few bands per thread are kept until they are written.
+
+      png_writer_t writer;
+      if (!writer.open(a_file_name, width, height))
+         return false;
+
+      a_thread_count = std::min(get_thread_count(a_thread_count), bands_count);
+      const int pending_count = 2 * a_thread_count;
+
+      std::vector<band_t> bands;
+      for (int thread_index = 0; thread_index < a_thread_count; ++thread_index)
+         bands.emplace_back(width, band_height, a_style);
+      std::vector<std::vector<std::uint8_t>> band_pixels(pending_count, std::vector<std::uint8_t>(size_t(width) * band_height * 3));
+
+      auto draw_band = [&](int a_band, band_t& a_buffer, std::uint8_t* some_pixels)
+      {
+         const int first_row = a_band * band_height;
+         a_buffer.reset(first_row, std::min(band_height, height - first_row));
+
+         pixel_point_t corners[4];
+         for (size_t index = band_starts[a_band]; index < band_starts[a_band + 1]; ++index)
+         {
+            get_corners(binned[index], corners);
+            a_buffer.fill_polygon(corners, 4, colors[binned[index].comb]);
+         }
+
+         if (a_style.edge_thickness > 0.)
+         {
+            for (size_t index = band_starts[a_band]; index < band_starts[a_band + 1]; ++index)
+            {
+               get_corners(binned[index], corners);
+               for (int ind = 0; ind < 4; ++ind)
+                  a_buffer.stroke_edge(corners[ind], corners[(ind + 1) % 4], a_style.edge_thickness);
+            }
+         }
+
+         a_buffer.resolve(a_style, some_pixels);
+      };
+
+      stop_flag_t never_stopped;
+      run_ordered(a_thread_count, bands_count, pending_count, never_stopped,
+         [&](int a_thread_index, size_t a_band, interruptor_t&)
+         {
+            draw_band(int(a_band), bands[a_thread_index], band_pixels[a_band % pending_count].data());
+            return true;
+         },
+         [&](size_t a_band)
+         {
+            const int rows_count = std::min(band_height, height - int(a_band) * band_height);
+            const std::uint8_t* pixels = band_pixels[a_band % pending_count].data();
+            for (int row = 0; row < rows_count; ++row)
+               writer.write_row(pixels + size_t(row) * width * 3);
+         });
+
+      return writer.close();
+   }
+}
@@ -0,0 +1,97 @@
+#include <dak/quasitiler/stats.h>
+
+#include <algorithm>
+#include <cstdio>
+
+
+namespace dak::quasitiler
+{
+   generate_stats_t& generate_stats_t::operator+=(const generate_stats_t& an_other)
+   {
+      init_seconds += an_other.init_seconds;
+      generate_seconds += an_other.generate_seconds;
+      plane_points += an_other.plane_points;
+      clipped_plane_points += an_other.clipped_plane_points;
+      candidates += an_other.candidates;
+      accepted += an_other.accepted;
+      inner_accepts += an_other.inner_accepts;
+      outer_rejects += an_other.outer_rejects;
+      criteria_tests += an_other.criteria_tests;
+      exact_tests += an_other.exact_tests;
+      criteria_count = std::max(criteria_count, an_other.criteria_count);
+      for (int criterion = 0; criterion < MAX_CRITERIA; ++criterion)
+         criterion_rejects[criterion] += an_other.criterion_rejects[criterion];
+      criteria_rejects += an_other.criteria_rejects;
+      return *this;
+   }
+
+   locate_stats_t& locate_stats_t::operator+=(const locate_stats_t& an_other)
+   {
+      index_seconds += an_other.index_seconds;
+      search_seconds += an_other.search_seconds;
+      vertices += an_other.vertices;
+      neighbor_lookups += an_other.neighbor_lookups;
+      neighbors_found += an_other.neighbors_found;
+      tiles += an_other.tiles;
+      binary_search_probes += an_other.binary_search_probes;
+      return *this;
+   }
+
+   namespace
+   {
+      void append_line(std::string& a_text, const char* a_name, std::uint64_t a_value)
+      {
+         char line[128];
+         std::snprintf(line, sizeof(line), "%s: %llu\n", a_name, (unsigned long long)a_value);
+         a_text += line;
+      }
+
+      void append_seconds(std::string& a_text, const char* a_name, double some_seconds)
+      {
+         char line[128];
+         std::snprintf(line, sizeof(line), "%s: %.6f s\n", a_name, some_seconds);
+         a_text += line;
+      }
+   }
+
+   std::string to_string(const generate_stats_t& some_stats)
+   {
+      if (!STATS_ENABLED)
+         return "statistics disabled\n";
+
+      std::string text;
+      append_seconds(text, "init", some_stats.init_seconds);
+      append_seconds(text, "generate", some_stats.generate_seconds);
+      append_line(text, "plane points", some_stats.plane_points);
+      append_line(text, "clipped plane points", some_stats.clipped_plane_points);
+      append_line(text, "candidates", some_stats.candidates);
+      append_line(text, "accepted", some_stats.accepted);
+      append_line(text, "inner ball accepts", some_stats.inner_accepts);
+      append_line(text, "outer ball rejects", some_stats.outer_rejects);
+      append_line(text, "criteria tests", some_stats.criteria_tests);
+      append_line(text, "exact tests", some_stats.exact_tests);
+      append_line(text, "criteria rejects", some_stats.criteria_rejects);
+      for (int criterion = 0; criterion < some_stats.criteria_count; ++criterion)
+      {
+         const std::string name = "criterion " + std::to_string(criterion) + " rejects";
+         append_line(text, name.c_str(), some_stats.criterion_rejects[criterion]);
+      }
+      return text;
+   }
+
+   std::string to_string(const locate_stats_t& some_stats)
+   {
+      if (!STATS_ENABLED)
+         return "statistics disabled\n";
+
+      std::string text;
+      append_seconds(text, "index", some_stats.index_seconds);
+      append_seconds(text, "search", some_stats.search_seconds);
+      append_line(text, "vertices", some_stats.vertices);
+      append_line(text, "neighbor lookups", some_stats.neighbor_lookups);
+      append_line(text, "neighbors found", some_stats.neighbors_found);
+      append_line(text, "tiles", some_stats.tiles);
+      append_line(text, "binary search probes", some_stats.binary_search_probes);
+      return text;
+   }
+}
@@ -0,0 +1,944 @@
+#include <dak/quasitiler/substitution_drawing.h>
+
+#include <cmath>
+#include <algorithm>
+#include <numbers>
+
+
+namespace dak::quasitiler
+{
+   // Projections closer than this are considered equal, and plane points
+   // closer than this to the side of a tile are considered on it.
+   static constexpr double SAME_MARGIN = 1e-9;
+
+   // How much further inside the window than the margin kept by the test
+   // of the cylinder a certain candidate is, relative to the window.
+   static constexpr double CERTAIN_MARGIN = 1e-5;
+
+   // The most lattice points searched for the candidates of the tiles.
+   static constexpr double MAX_CANDIDATE_SEARCH = double(1 << 24);
+
+   // A coarser level is only worth it when its region is at most this
+   // fraction of the area of the finer one.
+   static constexpr double MAX_LEVEL_AREA_RATIO = 0.5;
+   static constexpr size_t MAX_LEVELS = 32;
+
+   // How much further than its region the coarsest level is scanned, since
+   // the scan clips the plane points of its rows, not the lattice points.
+   static constexpr double SCAN_MARGIN = 2.;
+
+   // How many vertices or tiles are inflated between interruption checks.
+   static constexpr size_t INTERRUPT_PERIOD = 4096;
+
+   namespace
+   {
+      constexpr int TARGET_DIM = tiling_t::TARGET_DIM;
+      constexpr int WINDOW_DIM = tiling_t::WINDOW_DIM;
+
+      bool is_in_region(const double a_region[2][TARGET_DIM], const double a_point[TARGET_DIM])
+      {
+         return a_point[0] >= a_region[0][0] && a_point[0] <= a_region[1][0]
+             && a_point[1] >= a_region[0][1] && a_point[1] <= a_region[1][1];
+      }
+
+      // Reporter that only keeps the scanned vertices projected within the region.
+      struct region_reporter_t
+      {
+         region_reporter_t(drawing_t& a_drawing, const double a_region[2][TARGET_DIM])
+            : my_drawing(a_drawing), my_region(a_region)
+         {
+         }
+
+         void report_bounds(const int some_bounds[2][vertex_t::MAX_DIM], int a_dimensions_count)
+         {
+            my_drawing.report_bounds(some_bounds, a_dimensions_count);
+         }
+
+         void report_point(const vertex_t& a_point)
+         {
+            tiling_point_t point;
+            my_drawing.lattice_to_tiling(a_point, point);
+            const double plane[TARGET_DIM] = { point.x, point.y };
+            if (is_in_region(my_region, plane))
+               my_drawing.report_point(a_point);
+         }
+
+      private:
+         drawing_t&     my_drawing;
+         const double   (*my_region)[TARGET_DIM];
+      };
+
+      double dot_product(const window_polytope_t::point_t& a_point, const double some_coords[], int a_window_count)
+      {
+         double product = 0.;
+         for (int dim = 0; dim < a_window_count; ++dim)
+            product += a_point.coords[dim] * some_coords[dim];
+         return product;
+      }
+
+      double dot_product(const window_polytope_t::point_t& a_point, const window_polytope_t::point_t& an_other, int a_window_count)
+      {
+         return dot_product(a_point, an_other.coords, a_window_count);
+      }
+
+      // How far the window extends along the direction.
+      double window_extent(const double some_columns[][WINDOW_DIM], int a_dimensions_count, const window_polytope_t::point_t& a_direction)
+      {
+         const int window_count = a_dimensions_count - TARGET_DIM;
+
+         double extent = 0.;
+         for (int ind = 0; ind < a_dimensions_count; ++ind)
+         {
+            double along = 0.;
+            for (int dim = 0; dim < window_count; ++dim)
+               along += some_columns[ind][dim] * a_direction.coords[dim];
+            extent += std::abs(along) * 0.5;
+         }
+         return extent;
+      }
+
+      // How far the window inflated by the matrix extends along the normal.
+      double inflated_extent(const int an_inflation[][tiling_t::MAX_DIM], const double some_columns[][WINDOW_DIM],
+                             int a_dimensions_count, const window_polytope_t::point_t& a_normal)
+      {
+         const int window_count = a_dimensions_count - TARGET_DIM;
+
+         double extent = 0.;
+         for (int ind = 0; ind < a_dimensions_count; ++ind)
+         {
+            double along = 0.;
+            for (int row = 0; row < a_dimensions_count; ++row)
+               for (int dim = 0; dim < window_count; ++dim)
+                  along += an_inflation[row][ind] * some_columns[row][dim] * a_normal.coords[dim];
+            extent += std::abs(along) * 0.5;
+         }
+         return extent;
+      }
+
+      // Solve the linear system in place by Gaussian elimination with
+      // partial pivoting. Returns false when it is singular.
+      bool solve(double a_matrix[WINDOW_DIM][WINDOW_DIM], double some_values[], int a_size)
+      {
+         for (int col = 0; col < a_size; ++col)
+         {
+            int pivot = col;
+            for (int row = col + 1; row < a_size; ++row)
+               if (std::abs(a_matrix[row][col]) > std::abs(a_matrix[pivot][col]))
+                  pivot = row;
+            if (std::abs(a_matrix[pivot][col]) < SAME_MARGIN)
+               return false;
+
+            std::swap(a_matrix[col], a_matrix[pivot]);
+            std::swap(some_values[col], some_values[pivot]);
+
+            for (int row = col + 1; row < a_size; ++row)
+            {
+               const double ratio = a_matrix[row][col] / a_matrix[col][col];
+               for (int other = col; other < a_size; ++other)
+                  a_matrix[row][other] -= ratio * a_matrix[col][other];
+               some_values[row] -= ratio * some_values[col];
+            }
+         }
+
+         for (int row = a_size - 1; row >= 0; --row)
+         {
+            for (int col = row + 1; col < a_size; ++col)
+               some_values[row] -= a_matrix[row][col] * some_values[col];
+            some_values[row] /= a_matrix[row][row];
+         }
+
+         return true;
+      }
+
+      // The vertices of the polytope of the points whose dot product with the
+      // normal of each facet is at most the limit of the facet, where as many
+      // facet planes as the window has dimensions meet. A vertex where more
+      // planes meet is repeated.
+      std::vector<window_polytope_t::point_t> polytope_vertices(const std::vector<window_polytope_t::facet_t>& some_facets,
+                                                                const std::vector<double>& some_limits, int a_window_count)
+      {
+         std::vector<window_polytope_t::point_t> vertices;
+
+         const int facet_count = (int)some_facets.size();
+         if (facet_count < a_window_count)
+            return vertices;
+
+         int chosen[WINDOW_DIM];
+         for (int ind = 0; ind < a_window_count; ++ind)
+            chosen[ind] = ind;
+
+         while (true)
+         {
+            double matrix[WINDOW_DIM][WINDOW_DIM];
+            window_polytope_t::point_t vertex;
+            for (int row = 0; row < a_window_count; ++row)
+            {
+               for (int col = 0; col < a_window_count; ++col)
+                  matrix[row][col] = some_facets[chosen[row]].normal.coords[col];
+               vertex.coords[row] = some_limits[chosen[row]];
+            }
+
+            if (solve(matrix, vertex.coords, a_window_count))
+            {
+               bool is_inside = true;
+               for (int facet = 0; facet < facet_count && is_inside; ++facet)
+                  is_inside = dot_product(some_facets[facet].normal, vertex, a_window_count) <= some_limits[facet] + SAME_MARGIN;
+               if (is_inside)
+                  vertices.emplace_back(vertex);
+            }
+
+            int ind = a_window_count - 1;
+            while (ind >= 0 && chosen[ind] == facet_count - a_window_count + ind)
+               --ind;
+            if (ind < 0)
+               break;
+            ++chosen[ind];
+            for (int next = ind + 1; next < a_window_count; ++next)
+               chosen[next] = chosen[next - 1] + 1;
+         }
+
+         return vertices;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Generation.
+
+   bool substitution_drawing_t::generate(double tiling_bounds[2][tiling_t::MAX_DIM], drawing_t& a_drawing, interruptor_t& an_interruptor)
+   {
+      a_drawing.my_vertex_storage = drawing_t::vertex_list_t();
+      for (auto& tiles : a_drawing.my_tile_storage)
+         tiles.clear();
+
+      my_tiling->my_is_generated = false;
+      my_used_fallback = !find_inflation();
+
+      // The levels, from the drawing to the coarsest. The scan keeps
+      // the vertices within two units of the tiling bounds.
+
+      std::vector<level_t> levels(1);
+      levels[0].tiling = my_tiling;
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+      {
+         levels[0].region[0][dim] = tiling_bounds[0][dim] - 2.;
+         levels[0].region[1][dim] = tiling_bounds[1][dim] + 2.;
+      }
+
+      if (!my_used_fallback)
+         add_levels(levels);
+
+      if (levels.size() == 1)
+      {
+         if (!my_tiling->generate(tiling_bounds, a_drawing, an_interruptor))
+            return false;
+         return a_drawing.locate_tiles(an_interruptor);
+      }
+
+      // Scan the coarsest level.
+
+      const level_t& coarsest = levels.back();
+      double scan_bounds[2][MAX_DIM] = { };
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+      {
+         scan_bounds[0][dim] = coarsest.region[0][dim] - SCAN_MARGIN;
+         scan_bounds[1][dim] = coarsest.region[1][dim] + SCAN_MARGIN;
+      }
+
+      auto coarse = std::make_unique<drawing_t>(coarsest.tiling);
+      region_reporter_t reporter(*coarse, coarsest.region);
+      if (!coarsest.tiling->generate(scan_bounds, reporter, an_interruptor))
+         return false;
+      if (!coarse->locate_tiles(an_interruptor))
+         return false;
+
+      // Inflate it level by level, up to the drawing.
+
+      for (size_t level = levels.size() - 1; level > 0; --level)
+      {
+         const level_t& fine_level = levels[level - 1];
+         std::unique_ptr<drawing_t> fine = level > 1 ? std::make_unique<drawing_t>(fine_level.tiling) : nullptr;
+         drawing_t& fine_drawing = fine ? *fine : a_drawing;
+
+         report_region(fine_level.region, fine_drawing);
+         if (!inflate(*coarse, fine_level.region, fine_drawing, an_interruptor))
+            return false;
+
+         coarse = std::move(fine);
+      }
+
+      a_drawing.project_vertices(1);
+      a_drawing.order_vertices(1);
+      my_tiling->my_is_generated = true;
+      return true;
+   }
+
+   void substitution_drawing_t::add_levels(std::vector<level_t>& some_levels) const
+   {
+      const int dim_count = my_tiling->dimensions_count();
+      const int window_count = dim_count - TARGET_DIM;
+      const double* gens[TARGET_DIM] = { my_tiling->generator[0], my_tiling->generator[1] };
+
+      // A coarse tile covers part of the region once inflated when its base
+      // is within two generators of the shrunk region, and its tiles are
+      // located correctly when the neighbors of its base are also in the
+      // coarse drawing.
+
+      double longest = 0.;
+      for (int ind = 0; ind < dim_count; ++ind)
+         longest = std::max(longest, std::hypot(gens[0][ind], gens[1][ind]));
+      const double margin = 4. * longest;
+
+      while (some_levels.size() < MAX_LEVELS)
+      {
+         level_t coarse;
+         const level_t& fine = some_levels.back();
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+         {
+            coarse.region[0][dim] = fine.region[0][dim] / my_scale - margin;
+            coarse.region[1][dim] = fine.region[1][dim] / my_scale + margin;
+         }
+
+         const double fine_area = (fine.region[1][0] - fine.region[0][0]) * (fine.region[1][1] - fine.region[0][1]);
+         const double coarse_area = (coarse.region[1][0] - coarse.region[0][0]) * (coarse.region[1][1] - coarse.region[0][1]);
+         if (coarse_area > fine_area * MAX_LEVEL_AREA_RATIO)
+            return;
+
+         // The offset of the coarse tiling is the one the inflation takes
+         // to the offset of the fine tiling, in the orthogonal generators.
+
+         double matrix[WINDOW_DIM][WINDOW_DIM];
+         double relative_offset[MAX_DIM] = { };
+         for (int row = 0; row < window_count; ++row)
+         {
+            for (int col = 0; col < window_count; ++col)
+               matrix[row][col] = my_window_inflation[row][col];
+            for (int ind = 0; ind < dim_count; ++ind)
+               relative_offset[TARGET_DIM + row] += fine.tiling->offset[ind] * my_tiling->generator[TARGET_DIM + row][ind];
+         }
+         if (!solve(matrix, relative_offset + TARGET_DIM, window_count))
+            return;
+
+         coarse.tiling = std::make_shared<tiling_t>(dim_count);
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+            for (int ind = 0; ind < dim_count; ++ind)
+               coarse.tiling->generator[dim][ind] = gens[dim][ind];
+         coarse.tiling->set_cylinder_kernel(my_tiling->get_cylinder_kernel());
+         if (!coarse.tiling->init(relative_offset))
+            return;
+
+         // The relative offset is only meaningful with the same orthogonal generators.
+         for (int gen = TARGET_DIM; gen < dim_count; ++gen)
+            for (int ind = 0; ind < dim_count; ++ind)
+               if (std::abs(coarse.tiling->generator[gen][ind] - my_tiling->generator[gen][ind]) > SAME_MARGIN)
+                  return;
+
+         some_levels.emplace_back(coarse);
+      }
+   }
+
+   bool substitution_drawing_t::inflate(const drawing_t& a_coarse, const double a_region[2][TARGET_DIM], drawing_t& a_fine, interruptor_t& an_interruptor) const
+   {
+      const tiling_t& tiling = *a_fine.my_tiling;
+      const int dim_count = tiling.dimensions_count();
+      const int window_count = dim_count - TARGET_DIM;
+      const double* offset = tiling.offset;
+      const double* gens[TARGET_DIM] = { tiling.generator[0], tiling.generator[1] };
+      const std::vector<int>& signs = tiling.signs();
+      const std::vector<int>& slope_orders = tiling.slope_orders();
+
+      // A fine vertex is in the drawing when it is in the region and in the
+      // window: inside the ball inside the window, or not outside the ball
+      // around it and inside the cylinder. The projections are accumulated,
+      // so the region is verified with the exact projection near its border
+      // and the vertex is always decided the same way.
+
+      auto is_kept = [&](const vertex_t& a_vertex, const double a_plane[], const double a_window[], bool is_in_window)
+      {
+         bool is_near_border = false;
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+         {
+            if (a_plane[dim] < a_region[0][dim] - SAME_MARGIN || a_plane[dim] > a_region[1][dim] + SAME_MARGIN)
+               return false;
+            is_near_border = is_near_border || a_plane[dim] < a_region[0][dim] + SAME_MARGIN || a_plane[dim] > a_region[1][dim] - SAME_MARGIN;
+         }
+
+         if (is_near_border)
+         {
+            double plane[TARGET_DIM] = { };
+            for (int ind = 0; ind < dim_count; ++ind)
+               for (int dim = 0; dim < TARGET_DIM; ++dim)
+                  plane[dim] += a_vertex.coords[ind] * gens[dim][ind];
+            if (!is_in_region(a_region, plane))
+               return false;
+         }
+
+         if (is_in_window)
+            return true;
+
+         double radius_squared = 0.;
+         for (int dim = 0; dim < window_count; ++dim)
+            radius_squared += a_window[dim] * a_window[dim];
+         if (radius_squared <= tiling.my_inner_window_radius_squared)
+            return true;
+         if (radius_squared > tiling.my_outer_window_radius_squared)
+            return false;
+         return tiling.in_cylinder(a_vertex);
+      };
+
+      // Add a fine vertex and its tiles. The tiles are located as
+      // drawing_t::locate_tiles() does, but knowing which neighbors are in
+      // the drawing without looking them up.
+
+      point_batch_t batch(a_fine);
+      size_t fine_count = a_fine.my_vertex_storage.size();
+      auto add_vertex = [&](const vertex_t& a_vertex, const double a_plane[], const double a_window[])
+      {
+         int gen0 = -1;
+         for (int ind = 0; ind < dim_count; ++ind)
+         {
+            const int gen1 = slope_orders[ind];
+            const int sign = signs[gen1];
+
+            vertex_t neighbor = a_vertex;
+            neighbor.coords[gen1] += sign;
+            double plane[TARGET_DIM];
+            for (int dim = 0; dim < TARGET_DIM; ++dim)
+               plane[dim] = a_plane[dim] + sign * gens[dim][gen1];
+            double window[WINDOW_DIM];
+            for (int dim = 0; dim < window_count; ++dim)
+               window[dim] = a_window[dim] + sign * tiling.my_window_columns[gen1][dim];
+
+            if (is_kept(neighbor, plane, window, false))
+            {
+               if (gen0 >= 0)
+                  a_fine.my_tile_storage[tiling.tile_index[gen0][gen1]].emplace_back(fine_count);
+               gen0 = gen1;
+            }
+         }
+
+         batch.report_point(a_vertex);
+         ++fine_count;
+      };
+
+      // The extent of the inflated tiles of each combination around their base.
+
+      double reaches[tiling_t::MAX_TILE_COMB][2][TARGET_DIM];
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+      {
+         const int gen0 = tiling.tile_generator[comb][0];
+         const int gen1 = tiling.tile_generator[comb][1];
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+         {
+            const double side0 = my_scale * signs[gen0] * gens[dim][gen0];
+            const double side1 = my_scale * signs[gen1] * gens[dim][gen1];
+            reaches[comb][0][dim] = std::min(0., side0) + std::min(0., side1);
+            reaches[comb][1][dim] = std::max(0., side0) + std::max(0., side1);
+         }
+      }
+
+      // The tiles of each coarse vertex, so that the fine vertices are
+      // generated in the order of the coarse vertices.
+
+      const size_t coarse_count = a_coarse.my_vertex_storage.size();
+      std::vector<size_t> tile_starts(coarse_count + 1);
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+         for (size_t base : a_coarse.my_tile_storage[comb])
+            ++tile_starts[base + 1];
+      for (size_t index = 0; index < coarse_count; ++index)
+         tile_starts[index + 1] += tile_starts[index];
+
+      std::vector<int> tile_combs(tile_starts[coarse_count]);
+      {
+         std::vector<size_t> tile_ends(tile_starts.begin(), tile_starts.end() - 1);
+         for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+            for (size_t base : a_coarse.my_tile_storage[comb])
+               tile_combs[tile_ends[base]++] = comb;
+      }
+
+      // Inflate each coarse vertex, then add the candidates of its inflated
+      // tiles that reach the region.
+
+      for (size_t index = 0; index < coarse_count; ++index)
+      {
+         // Check if the user wants to stop right now.
+         if (0 == (index % INTERRUPT_PERIOD) && an_interruptor.interrupted())
+            return false;
+
+         const vertex_t coarse = a_coarse.my_vertex_storage[index];
+         vertex_t inflated;
+         for (int row = 0; row < dim_count; ++row)
+            for (int col = 0; col < dim_count; ++col)
+               inflated.coords[row] += my_inflation[row][col] * coarse.coords[col];
+
+         double plane[TARGET_DIM] = { };
+         double window[WINDOW_DIM] = { };
+         for (int ind = 0; ind < dim_count; ++ind)
+         {
+            for (int dim = 0; dim < TARGET_DIM; ++dim)
+               plane[dim] += inflated.coords[ind] * gens[dim][ind];
+            for (int dim = 0; dim < window_count; ++dim)
+               window[dim] += (inflated.coords[ind] - offset[ind]) * tiling.my_window_columns[ind][dim];
+         }
+
+         if (is_kept(inflated, plane, window, my_is_contracting))
+            add_vertex(inflated, plane, window);
+
+         for (size_t tile = tile_starts[index]; tile < tile_starts[index + 1]; ++tile)
+         {
+            const int comb = tile_combs[tile];
+            const double (*reach)[TARGET_DIM] = reaches[comb];
+            if (plane[0] + reach[1][0] < a_region[0][0] - SAME_MARGIN || plane[0] + reach[0][0] > a_region[1][0] + SAME_MARGIN
+               || plane[1] + reach[1][1] < a_region[0][1] - SAME_MARGIN || plane[1] + reach[0][1] > a_region[1][1] + SAME_MARGIN)
+               continue;
+
+            for (const candidate_t& candidate : my_candidates[comb])
+            {
+               vertex_t fine = inflated;
+               for (int ind = 0; ind < dim_count; ++ind)
+                  fine.coords[ind] += candidate.step.coords[ind];
+
+               double fine_plane[TARGET_DIM];
+               for (int dim = 0; dim < TARGET_DIM; ++dim)
+                  fine_plane[dim] = plane[dim] + candidate.plane[dim];
+               double fine_window[WINDOW_DIM];
+               for (int dim = 0; dim < window_count; ++dim)
+                  fine_window[dim] = window[dim] + candidate.window[dim];
+
+               if (is_kept(fine, fine_plane, fine_window, candidate.is_certain))
+                  add_vertex(fine, fine_plane, fine_window);
+            }
+         }
+      }
+
+      batch.flush();
+      return true;
+   }
+
+   void substitution_drawing_t::report_region(const double a_region[2][TARGET_DIM], drawing_t& a_drawing) const
+   {
+      const tiling_t& tiling = *a_drawing.my_tiling;
+      const int dim_count = tiling.dimensions_count();
+
+      // A lattice coordinate of a vertex differs from the one of its
+      // projection to the plane by at most the radius of the window.
+
+      const double thick = tiling.get_window_polytope().get_outer_radius() + 1.;
+
+      int bounds[2][MAX_DIM] = { };
+      for (int ind = 0; ind < dim_count; ++ind)
+      {
+         double low = tiling.offset[ind];
+         double high = tiling.offset[ind];
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+         {
+            const double start = tiling.generator[dim][ind] * a_region[0][dim];
+            const double end = tiling.generator[dim][ind] * a_region[1][dim];
+            low += std::min(start, end);
+            high += std::max(start, end);
+         }
+         bounds[0][ind] = (int)std::floor(low - thick);
+         bounds[1][ind] = (int)std::ceil(high + thick);
+      }
+
+      a_drawing.report_bounds(bounds, dim_count);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Inflation.
+
+   bool substitution_drawing_t::find_inflation()
+   {
+      const int dim_count = my_tiling->dimensions_count();
+      const int window_count = dim_count - TARGET_DIM;
+      const double* gens[TARGET_DIM] = { my_tiling->generator[0], my_tiling->generator[1] };
+
+      // The inflation only depends on the generators of the plane.
+
+      bool is_known = (my_inflated_dimensions_count == dim_count);
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+         for (int ind = 0; ind < dim_count; ++ind)
+            is_known = is_known && my_inflated_generators[dim][ind] == gens[dim][ind];
+      if (is_known)
+         return my_has_inflation;
+
+      my_inflated_dimensions_count = dim_count;
+      for (int dim = 0; dim < TARGET_DIM; ++dim)
+         for (int ind = 0; ind < dim_count; ++ind)
+            my_inflated_generators[dim][ind] = gens[dim][ind];
+      my_has_inflation = false;
+      for (auto& candidates : my_candidates)
+         candidates.clear();
+
+      // Rotating the plane by pi / n must take each projected generator to
+      // another one or to its opposite, each reached once.
+
+      const double angle = std::numbers::pi / dim_count;
+      const double cos_angle = std::cos(angle);
+      const double sin_angle = std::sin(angle);
+
+      int permutation[MAX_DIM][MAX_DIM] = { };
+      for (int ind = 0; ind < dim_count; ++ind)
+      {
+         const double rotated[TARGET_DIM] =
+         {
+            cos_angle * gens[0][ind] - sin_angle * gens[1][ind],
+            sin_angle * gens[0][ind] + cos_angle * gens[1][ind],
+         };
+
+         int found_count = 0;
+         for (int other = 0; other < dim_count; ++other)
+         {
+            for (int sign = -1; sign <= 1; sign += 2)
+            {
+               if (std::abs(rotated[0] - sign * gens[0][other]) < SAME_MARGIN
+                  && std::abs(rotated[1] - sign * gens[1][other]) < SAME_MARGIN)
+               {
+                  permutation[other][ind] = sign;
+                  ++found_count;
+               }
+            }
+         }
+         if (found_count != 1)
+            return false;
+      }
+
+      for (int row = 0; row < dim_count; ++row)
+      {
+         int reached_count = 0;
+         for (int col = 0; col < dim_count; ++col)
+            reached_count += std::abs(permutation[row][col]);
+         if (reached_count != 1)
+            return false;
+      }
+
+      // The identity plus the rotation and its inverse.
+
+      for (int row = 0; row < dim_count; ++row)
+         for (int col = 0; col < dim_count; ++col)
+            my_inflation[row][col] = (row == col ? 1 : 0) + permutation[row][col] + permutation[col][row];
+      my_scale = 1. + 2. * cos_angle;
+
+      for (int row = 0; row < window_count; ++row)
+      {
+         for (int col = 0; col < window_count; ++col)
+         {
+            double inflation = 0.;
+            for (int ind = 0; ind < dim_count; ++ind)
+               for (int other = 0; other < dim_count; ++other)
+                  inflation += my_tiling->generator[TARGET_DIM + row][ind] * my_inflation[ind][other] * my_tiling->generator[TARGET_DIM + col][other];
+            my_window_inflation[row][col] = inflation;
+         }
+      }
+
+      // The inflated window must be inside the window, so that the inflated
+      // vertices are vertices.
+
+      double largest_ratio = 0.;
+      for (const window_polytope_t::facet_t& facet : my_tiling->get_window_polytope().get_facets())
+      {
+         const double extent = inflated_extent(my_inflation, my_tiling->my_window_columns, dim_count, facet.normal);
+         largest_ratio = std::max(largest_ratio, extent / facet.distance);
+      }
+      if (largest_ratio > 1. + SAME_MARGIN)
+         return false;
+      my_is_contracting = largest_ratio < 1. - SAME_MARGIN;
+
+      my_has_inflation = find_candidates();
+      return my_has_inflation;
+   }
+
+   bool substitution_drawing_t::find_candidates()
+   {
+      const tiling_t& tiling = *my_tiling;
+      const int dim_count = tiling.dimensions_count();
+      const int window_count = dim_count - TARGET_DIM;
+      const double* gens[TARGET_DIM] = { tiling.generator[0], tiling.generator[1] };
+      const std::vector<int>& signs = tiling.signs();
+      const window_polytope_t& polytope = tiling.get_window_polytope();
+      const std::vector<window_polytope_t::facet_t>& facets = polytope.get_facets();
+
+      // A fine vertex is relative to the inflated base of a coarse tile by
+      // a point of the window minus a point of the inflated window, so it is
+      // within the sum of their extents along each facet normal.
+
+      std::vector<double> limits;
+      for (const window_polytope_t::facet_t& facet : facets)
+         limits.emplace_back(facet.distance + inflated_extent(my_inflation, tiling.my_window_columns, dim_count, facet.normal) + SAME_MARGIN);
+
+      // More precisely, the base of a coarse tile is in the window translated
+      // back from each corner of the tile: the domain of its combination. The
+      // candidates of the combination are those from which the inflated domain
+      // reaches into the window, which is verified along the normals of the
+      // facets of the window and of the inflated domain.
+
+      std::vector<window_polytope_t::point_t> directions;
+      for (const window_polytope_t::facet_t& facet : facets)
+      {
+         directions.emplace_back(facet.normal);
+
+         double matrix[WINDOW_DIM][WINDOW_DIM];
+         for (int row = 0; row < window_count; ++row)
+            for (int col = 0; col < window_count; ++col)
+               matrix[row][col] = my_window_inflation[row][col];
+         window_polytope_t::point_t inflated_normal = facet.normal;
+         if (solve(matrix, inflated_normal.coords, window_count))
+            directions.emplace_back(inflated_normal);
+      }
+
+      // In three dimensions, two polytopes can also be separated only along
+      // the cross product of an edge of each. The edges of the window are
+      // along the generators, the edges of an inflated domain along where
+      // two facet planes meet, inflated.
+
+      if (window_count == 3)
+      {
+         auto cross_product = [](const window_polytope_t::point_t& a_point, const window_polytope_t::point_t& an_other)
+         {
+            window_polytope_t::point_t product;
+            product.coords[0] = a_point.coords[1] * an_other.coords[2] - a_point.coords[2] * an_other.coords[1];
+            product.coords[1] = a_point.coords[2] * an_other.coords[0] - a_point.coords[0] * an_other.coords[2];
+            product.coords[2] = a_point.coords[0] * an_other.coords[1] - a_point.coords[1] * an_other.coords[0];
+            return product;
+         };
+
+         std::vector<window_polytope_t::point_t> domain_edges;
+         for (size_t facet0 = 0; facet0 < facets.size(); facet0 += 2)
+         {
+            for (size_t facet1 = facet0 + 2; facet1 < facets.size(); facet1 += 2)
+            {
+               const window_polytope_t::point_t edge = cross_product(facets[facet0].normal, facets[facet1].normal);
+               window_polytope_t::point_t inflated;
+               for (int row = 0; row < window_count; ++row)
+                  for (int col = 0; col < window_count; ++col)
+                     inflated.coords[row] += my_window_inflation[row][col] * edge.coords[col];
+               domain_edges.emplace_back(inflated);
+            }
+         }
+
+         for (int ind = 0; ind < dim_count; ++ind)
+         {
+            window_polytope_t::point_t window_edge;
+            for (int dim = 0; dim < window_count; ++dim)
+               window_edge.coords[dim] = tiling.my_window_columns[ind][dim];
+
+            for (const window_polytope_t::point_t& domain_edge : domain_edges)
+            {
+               window_polytope_t::point_t direction = cross_product(window_edge, domain_edge);
+               const double norm = std::sqrt(dot_product(direction, direction, window_count));
+               if (norm < SAME_MARGIN)
+                  continue;
+               for (int dim = 0; dim < window_count; ++dim)
+                  direction.coords[dim] /= norm;
+               directions.emplace_back(direction);
+               for (int dim = 0; dim < window_count; ++dim)
+                  direction.coords[dim] = -direction.coords[dim];
+               directions.emplace_back(direction);
+            }
+         }
+      }
+
+      std::vector<double> extents;
+      for (const window_polytope_t::point_t& direction : directions)
+         extents.emplace_back(window_extent(tiling.my_window_columns, dim_count, direction));
+
+      std::vector<window_polytope_t::point_t> inflated_domains[tiling_t::MAX_TILE_COMB];
+      std::vector<double> nearests[tiling_t::MAX_TILE_COMB];
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+      {
+         const int gen0 = tiling.tile_generator[comb][0];
+         const int gen1 = tiling.tile_generator[comb][1];
+
+         std::vector<double> domain_limits;
+         for (const window_polytope_t::facet_t& facet : facets)
+         {
+            double furthest = 0.;
+            for (int corner = 1; corner < 4; ++corner)
+            {
+               double along = 0.;
+               for (int dim = 0; dim < window_count; ++dim)
+               {
+                  double coord = 0.;
+                  if (corner & 1)
+                     coord += signs[gen0] * tiling.my_window_columns[gen0][dim];
+                  if (corner & 2)
+                     coord += signs[gen1] * tiling.my_window_columns[gen1][dim];
+                  along += facet.normal.coords[dim] * coord;
+               }
+               furthest = std::max(furthest, along);
+            }
+            domain_limits.emplace_back(facet.distance - furthest);
+         }
+
+         for (const window_polytope_t::point_t& vertex : polytope_vertices(facets, domain_limits, window_count))
+         {
+            window_polytope_t::point_t inflated;
+            for (int row = 0; row < window_count; ++row)
+               for (int col = 0; col < window_count; ++col)
+                  inflated.coords[row] += my_window_inflation[row][col] * vertex.coords[col];
+            inflated_domains[comb].emplace_back(inflated);
+         }
+
+         for (const window_polytope_t::point_t& direction : directions)
+         {
+            double nearest = HUGE_VAL;
+            for (const window_polytope_t::point_t& vertex : inflated_domains[comb])
+               nearest = std::min(nearest, dot_product(direction, vertex, window_count));
+            nearests[comb].emplace_back(nearest);
+         }
+      }
+
+      double inflated_radius = 0.;
+      for (const window_polytope_t::point_t& vertex : polytope.get_vertices())
+      {
+         double radius_squared = 0.;
+         for (int row = 0; row < window_count; ++row)
+         {
+            double coord = 0.;
+            for (int col = 0; col < window_count; ++col)
+               coord += my_window_inflation[row][col] * vertex.coords[col];
+            radius_squared += coord * coord;
+         }
+         inflated_radius = std::max(inflated_radius, std::sqrt(radius_squared));
+      }
+
+      // The inflated tiles are within two inflated generators of their base.
+
+      double longest = 0.;
+      for (int ind = 0; ind < dim_count; ++ind)
+         longest = std::max(longest, std::hypot(gens[0][ind], gens[1][ind]));
+      const double plane_reach = 2. * my_scale * longest + SAME_MARGIN;
+      const double window_reach = polytope.get_outer_radius() + inflated_radius + SAME_MARGIN;
+
+      // The range of each lattice coordinate of the candidates.
+
+      int reach[MAX_DIM] = { };
+      double search_count = 1.;
+      for (int ind = 0; ind < dim_count; ++ind)
+      {
+         double window_length = 0.;
+         for (int dim = 0; dim < window_count; ++dim)
+            window_length += tiling.my_window_columns[ind][dim] * tiling.my_window_columns[ind][dim];
+         reach[ind] = (int)std::floor(plane_reach * std::hypot(gens[0][ind], gens[1][ind]) + window_reach * std::sqrt(window_length));
+         search_count *= 2. * reach[ind] + 1.;
+      }
+      if (search_count > MAX_CANDIDATE_SEARCH)
+         return false;
+
+      // The sides of the inflated tiles.
+
+      double sides[tiling_t::MAX_TILE_COMB][2][TARGET_DIM];
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+      {
+         for (int side = 0; side < 2; ++side)
+         {
+            const int gen = tiling.tile_generator[comb][side];
+            for (int dim = 0; dim < TARGET_DIM; ++dim)
+               sides[comb][side][dim] = my_scale * signs[gen] * gens[dim][gen];
+         }
+      }
+
+      // Go over the lattice points in range, keeping their projections up to date.
+
+      vertex_t step;
+      double plane[TARGET_DIM] = { };
+      double window[WINDOW_DIM] = { };
+      auto move = [&](int a_coord, int a_delta)
+      {
+         step.coords[a_coord] += a_delta;
+         for (int dim = 0; dim < TARGET_DIM; ++dim)
+            plane[dim] += a_delta * gens[dim][a_coord];
+         for (int dim = 0; dim < window_count; ++dim)
+            window[dim] += a_delta * tiling.my_window_columns[a_coord][dim];
+      };
+
+      for (int ind = 0; ind < dim_count; ++ind)
+         move(ind, -reach[ind]);
+
+      auto is_within = [](double a_param) { return a_param > SAME_MARGIN && a_param < 1. - SAME_MARGIN; };
+      auto is_at = [](double a_param, double an_end) { return std::abs(a_param - an_end) <= SAME_MARGIN; };
+
+      while (true)
+      {
+         bool is_candidate = plane[0] * plane[0] + plane[1] * plane[1] <= plane_reach * plane_reach;
+         for (size_t facet = 0; facet < facets.size() && is_candidate; ++facet)
+         {
+            double along = 0.;
+            for (int dim = 0; dim < window_count; ++dim)
+               along += facets[facet].normal.coords[dim] * window[dim];
+            is_candidate = along <= limits[facet];
+         }
+
+         if (is_candidate)
+         {
+            // The projections are recomputed to not accumulate rounding errors.
+
+            candidate_t candidate;
+            candidate.step = step;
+            for (int ind = 0; ind < dim_count; ++ind)
+            {
+               for (int dim = 0; dim < TARGET_DIM; ++dim)
+                  candidate.plane[dim] += step.coords[ind] * gens[dim][ind];
+               for (int dim = 0; dim < window_count; ++dim)
+                  candidate.window[dim] += step.coords[ind] * tiling.my_window_columns[ind][dim];
+            }
+
+            // Each inflated tile owns its interior and the two sides with the
+            // interior on their left, going along their generator: the tile
+            // on the other side of such a side has its interior on the right.
+            // The corners are the inflated coarse vertices.
+
+            for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+            {
+               const double* side0 = sides[comb][0];
+               const double* side1 = sides[comb][1];
+               const double det = side0[0] * side1[1] - side0[1] * side1[0];
+               const double along0 = (candidate.plane[0] * side1[1] - candidate.plane[1] * side1[0]) / det;
+               const double along1 = (side0[0] * candidate.plane[1] - side0[1] * candidate.plane[0]) / det;
+
+               const bool is_owned = (is_within(along0) && is_within(along1))
+                                  || (det > 0. ? (is_within(along0) && is_at(along1, 0.)) || (is_at(along0, 1.) && is_within(along1))
+                                               : (is_at(along0, 0.) && is_within(along1)) || (is_within(along0) && is_at(along1, 1.)));
+               if (!is_owned)
+                  continue;
+
+               bool is_reached = !inflated_domains[comb].empty();
+               for (size_t direction = 0; direction < directions.size() && is_reached; ++direction)
+                  is_reached = dot_product(directions[direction], candidate.window, window_count) + nearests[comb][direction] <= extents[direction] + SAME_MARGIN;
+               if (!is_reached)
+                  continue;
+
+               // The candidate is certain when it is inside the window from
+               // all the corners of the inflated domain.
+
+               candidate.is_certain = std::all_of(inflated_domains[comb].begin(), inflated_domains[comb].end(), [&](const window_polytope_t::point_t& a_vertex)
+               {
+                  return std::all_of(facets.begin(), facets.end(), [&](const window_polytope_t::facet_t& a_facet)
+                  {
+                     return dot_product(a_facet.normal, a_vertex, window_count) + dot_product(a_facet.normal, candidate.window, window_count)
+                        <= (1. - CERTAIN_MARGIN) * a_facet.distance;
+                  });
+               });
+
+               my_candidates[comb].emplace_back(candidate);
+            }
+         }
+
+         int ind = 0;
+         for (; ind < dim_count; ++ind)
+         {
+            if (step.coords[ind] < reach[ind])
+            {
+               move(ind, 1);
+               break;
+            }
+            move(ind, -2 * reach[ind]);
+         }
+         if (ind == dim_count)
+            break;
+      }
+
+      return true;
+   }
+}
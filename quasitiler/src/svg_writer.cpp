@@ -0,0 +1,162 @@
+#include <dak/quasitiler/svg_writer.h>
+
+#include <charconv>
+#include <cstdio>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Writer.
+
+   svg_writer_t::svg_writer_t(std::shared_ptr<tiling_t> a_tiling, const svg_style_t& a_style)
+      : my_tiling(a_tiling), my_style(a_style)
+   {
+      // Premultiply the edge generators by their correct sign and go around
+      // the tile: along the first generator, the second, then back.
+      const tiling_t& tiling = *my_tiling;
+      for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+      {
+         const int gen0 = tiling.tile_generator[comb][0];
+         const int gen1 = tiling.tile_generator[comb][1];
+         const double gen0_x = tiling.signs()[gen0] * tiling.generator[0][gen0];
+         const double gen0_y = tiling.signs()[gen0] * tiling.generator[1][gen0];
+         const double gen1_x = tiling.signs()[gen1] * tiling.generator[0][gen1];
+         const double gen1_y = tiling.signs()[gen1] * tiling.generator[1][gen1];
+
+         std::string& moves = my_tile_moves[comb];
+         moves = "l";
+         for (const double value : { gen0_x, gen0_y, gen1_x, gen1_y, -gen0_x, -gen0_y })
+         {
+            moves += ' ';
+            append_coord(moves, value);
+         }
+         moves += 'z';
+      }
+   }
+
+   svg_writer_t::~svg_writer_t()
+   {
+      close();
+   }
+
+   bool svg_writer_t::open(const std::filesystem::path& a_file_name, const double tiling_bounds[2][tiling_t::MAX_DIM])
+   {
+      if (!my_writer.open(a_file_name))
+         return false;
+
+      std::string& out = my_writer.buffer();
+
+      auto append_color = [&out](std::uint32_t a_color)
+      {
+         char text[8];
+         std::snprintf(text, sizeof(text), "#%06x", unsigned(a_color & 0xFFFFFF));
+         out += text;
+      };
+
+      out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+      out += "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"";
+      append_coord(out, tiling_bounds[0][0]);
+      out += ' ';
+      append_coord(out, tiling_bounds[0][1]);
+      out += ' ';
+      append_coord(out, tiling_bounds[1][0] - tiling_bounds[0][0]);
+      out += ' ';
+      append_coord(out, tiling_bounds[1][1] - tiling_bounds[0][1]);
+      out += "\">\n";
+
+      // The styles, once per tile combination.
+      out += "<style>\n";
+      if (my_style.edge_thickness > 0.)
+      {
+         out += "path { stroke: ";
+         append_color(my_style.edge_color);
+         char width[32];
+         std::snprintf(width, sizeof(width), "%g", my_style.edge_thickness);
+         out += "; stroke-width: ";
+         out += width;
+         out += "; stroke-linejoin: round; }\n";
+      }
+      else
+      {
+         out += "path { stroke: none; }\n";
+      }
+      std::uint32_t tile_colors[tiling_t::MAX_TILE_COMB];
+      interpolate_tile_colors(my_tiling->dimensions_count(), my_style.tile_group_colors, tile_colors);
+      for (int comb = 0; comb < my_tiling->tile_combinations_count(); ++comb)
+      {
+         out += ".c" + std::to_string(comb) + " { fill: ";
+         append_color(tile_colors[comb]);
+         out += "; }\n";
+      }
+      out += "</style>\n";
+
+      my_writer.commit();
+      return true;
+   }
+
+   bool svg_writer_t::close()
+   {
+      if (!my_writer.is_open())
+         return false;
+
+      my_writer.write("</svg>\n");
+      return my_writer.close();
+   }
+
+   void svg_writer_t::write_tiles(const drawing_t& a_drawing)
+   {
+      if (!my_writer.is_open())
+         return;
+
+      // The buffer stays the same string when its content is handed off
+      // to the background thread.
+      std::string& out = my_writer.buffer();
+
+      const drawing_t::vertex_list_t& vertices = a_drawing.get_vertex_storage();
+      for (int comb = 0; comb < my_tiling->tile_combinations_count(); ++comb)
+      {
+         const drawing_t::tile_list_t& tiles = a_drawing.get_tile_storage()[comb];
+         if (tiles.empty())
+            continue;
+
+         out += "<path class=\"c" + std::to_string(comb) + "\" d=\"";
+         for (const size_t vertex_index : tiles)
+         {
+            tiling_point_t point;
+            a_drawing.lattice_to_tiling(vertices[vertex_index], point);
+
+            out += 'M';
+            append_coord(out, point.x);
+            out += ' ';
+            append_coord(out, point.y);
+            out += my_tile_moves[comb];
+            my_writer.commit();
+         }
+         out += "\"/>\n";
+         my_writer.commit();
+      }
+   }
+
+   void svg_writer_t::append_coord(std::string& a_buffer, double a_value) const
+   {
+      char text[64];
+      const auto result = std::to_chars(text, text + sizeof(text), a_value * my_style.tile_size, std::chars_format::fixed, my_style.decimals);
+      a_buffer.append(text, result.ptr);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Whole drawing.
+
+   bool write_svg_file(const std::filesystem::path& a_file_name, const drawing_t& a_drawing,
+                       const double tiling_bounds[2][tiling_t::MAX_DIM], const svg_style_t& a_style)
+   {
+      svg_writer_t writer(a_drawing.get_tiling(), a_style);
+      if (!writer.open(a_file_name, tiling_bounds))
+         return false;
+      writer.write_tiles(a_drawing);
+      return writer.close();
+   }
+}
@@ -0,0 +1,94 @@
+#include <dak/quasitiler/tile_colors.h>
+
+
+namespace dak::quasitiler
+{
+   static constexpr std::uint32_t rgb(int r, int g, int b)
+   {
+      return (std::uint32_t(r) << 16) | (std::uint32_t(g) << 8) | std::uint32_t(b);
+   }
+
+   void get_default_tile_group_colors(tile_group_colors_t& some_group_colors)
+   {
+      for (int row = 0; row < TILE_COLOR_GROUP_COUNT; ++row)
+      {
+         const int v = 255 - (row / 6) * 15;
+         switch (row % 6)
+         {
+         case 0:
+            some_group_colors[row][0] = rgb(v, 80, 80);
+            some_group_colors[row][1] = rgb(80, 80, v);
+            break;
+         case 1:
+            some_group_colors[row][0] = rgb(80, v, 80);
+            some_group_colors[row][1] = rgb(80, v, v);
+            break;
+         case 2:
+            some_group_colors[row][0] = rgb(v, 80, v);
+            some_group_colors[row][1] = rgb(v, v, 80);
+            break;
+         case 3:
+            some_group_colors[row][0] = rgb(v, v / 2, 0);
+            some_group_colors[row][1] = rgb(0, v / 2, v);
+            break;
+         case 4:
+            some_group_colors[row][0] = rgb(v / 2, v, 0);
+            some_group_colors[row][1] = rgb(0, v, v / 2);
+            break;
+         case 5:
+            some_group_colors[row][0] = rgb(v, 0, v / 2);
+            some_group_colors[row][1] = rgb(v, v / 2, 0);
+            break;
+         }
+      }
+   }
+
+   int get_tile_color_group(int a_tile_comb, int a_dimensions_count)
+   {
+      return a_tile_comb / a_dimensions_count;
+   }
+
+   std::uint32_t interpolate_tile_color(int a_tile_comb, int a_dimensions_count, std::uint32_t a_first_color, std::uint32_t a_second_color)
+   {
+      const int row = a_tile_comb / a_dimensions_count;
+      const int col = a_tile_comb % a_dimensions_count;
+
+      int row_count;
+      if (row >= a_dimensions_count / 2 - 1
+              && a_dimensions_count % 2 == 0)
+      {
+         row_count = a_dimensions_count / 2 - 1;
+      }
+      else
+      {
+         row_count = a_dimensions_count - 1;
+      }
+
+      // Interpolate color.
+
+      const double cof = row_count > 0 ? (double)col / (double)row_count : 0.;
+      const double cof_complement = 1. - cof;
+
+      auto channel = [&](int a_shift)
+      {
+         const int first = (a_first_color >> a_shift) & 0xFF;
+         const int second = (a_second_color >> a_shift) & 0xFF;
+         return (int)(cof_complement * first + cof * second);
+      };
+
+      return rgb(channel(16), channel(8), channel(0));
+   }
+
+   void interpolate_tile_colors(int a_dimensions_count, const tile_group_colors_t& some_group_colors, std::uint32_t some_tile_colors[tiling_t::MAX_TILE_COMB])
+   {
+      const int comb_count = a_dimensions_count * (a_dimensions_count - 1) / 2;
+      for (int comb = 0; comb < tiling_t::MAX_TILE_COMB; ++comb)
+      {
+         const int group = get_tile_color_group(comb, a_dimensions_count);
+         if (comb >= comb_count || group >= TILE_COLOR_GROUP_COUNT)
+            some_tile_colors[comb] = 0;
+         else
+            some_tile_colors[comb] = interpolate_tile_color(comb, a_dimensions_count, some_group_colors[group][0], some_group_colors[group][1]);
+      }
+   }
+}
@@ -1,7 +1,10 @@
 #include <dak/quasitiler/tiling.h>
+#include <dak/quasitiler/parallel.h>
+#include <dak/quasitiler/vertex_index.h>
 
 #include <cmath>
 #include <algorithm>
+#include <bit>
 
 
 namespace dak::quasitiler
@@ -27,16 +30,6 @@ namespace dak::quasitiler
             : 0;
    }
 
-   static const int my_floor(double x)
-   {
-      return (int)floor(x);
-   }
-
-   static const int my_ceil(double x)
-   {
-      return (int)ceil(x);
-   }
-
    ////////////////////////////////////////////////////////////////////////////
    //
    // Constructor.
@@ -65,6 +58,9 @@ namespace dak::quasitiler
 
    bool tiling_t::init(double relative_offset[])
    {
+      my_generate_stats = generate_stats_t();
+      stats_timer_t timer(my_generate_stats.init_seconds);
+
       my_cylinder_criteria_count = my_dimensions_count * (my_dimensions_count - 1) * (my_dimensions_count - 2) / 6;
       my_tile_combinations_count = my_dimensions_count * (my_dimensions_count - 1) / 2;
 
@@ -88,6 +84,8 @@ namespace dak::quasitiler
       if (!compute_cylinder())
          return false;
 
+      compute_window();
+
       // Sort the usual coordinate basis wrt this tiling.
 
       sort_coordinates();
@@ -311,9 +309,190 @@ namespace dak::quasitiler
          for (; ind <= TARGET_DIM; ++ind)
             choice[ind] = choice[ind - 1] + 1;
       }
+
+      // Keep the criteria transposed too, in the order computed above
+      // until an adaptive order is sampled.
+
+      int criteria[MAX_CYLR_COMB];
+      for (int crit_index = 0; crit_index < my_cylinder_criteria_count; ++crit_index)
+         criteria[crit_index] = crit_index;
+      fill_cylinder_columns(criteria);
+      my_is_criteria_order_sampled = false;
+
       return true;
    }
 
+   // The transposed criteria put the contribution of one coordinate
+   // to all criteria contiguously.
+
+   void tiling_t::fill_cylinder_columns(const int some_criteria[])
+   {
+      my_cylinder_columns = cylinder_columns_t();
+      my_cylinder_columns.dimensions_count = my_dimensions_count;
+      my_cylinder_columns.criteria_count = my_cylinder_criteria_count;
+      my_cylinder_columns.padded_criteria_count = (my_cylinder_criteria_count + cylinder_columns_t::CRITERIA_ALIGN - 1)
+                                                / cylinder_columns_t::CRITERIA_ALIGN * cylinder_columns_t::CRITERIA_ALIGN;
+      for (int column = 0; column < my_cylinder_criteria_count; ++column)
+         for (int ind = 0; ind < my_dimensions_count; ++ind)
+            my_cylinder_columns.columns[ind][column] = my_cylinder_criteria[some_criteria[column]][ind];
+   }
+
+   // The farthest points of the window are projected corners of the cube,
+   // and its nearest points are on the faces given by the criteria, at one
+   // over the norm of the criterion, since the criteria are in the
+   // orthogonal space. The radii leave room for the rounding of the
+   // projection and the epsilon of the exact test.
+
+   static constexpr double WINDOW_MARGIN = 1e-9;
+
+   void tiling_t::compute_window()
+   {
+      const int window_count = my_dimensions_count - TARGET_DIM;
+      for (int ind = 0; ind < MAX_DIM; ++ind)
+         for (int dim = 0; dim < WINDOW_DIM; ++dim)
+            my_window_columns[ind][dim] = (ind < my_dimensions_count && dim < window_count) ? generator[TARGET_DIM + dim][ind] : 0.;
+
+      // The closest facet of the window is the one of the longest criterion
+      // and the furthest point is one of its vertices.
+
+      my_window_polytope = window_polytope_t(my_window_columns, my_dimensions_count);
+
+      const double inner_radius = std::max(0., (1.0 - EPSILON) * my_window_polytope.get_inner_radius() - WINDOW_MARGIN);
+      const double outer_radius = my_window_polytope.get_outer_radius() + WINDOW_MARGIN;
+      my_inner_window_radius_squared = inner_radius * inner_radius;
+      my_outer_window_radius_squared = outer_radius * outer_radius;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Adaptive order of the criteria.
+
+   // Rows sampled and the rejected points kept from each, and the minimum
+   // number of rows in the scan to sample them, so the sampling stays a
+   // small part of the scan.
+   static constexpr int CRITERIA_SAMPLE_ROWS = 16;
+   static constexpr size_t CRITERIA_SAMPLE_ROW_POINTS = 1024;
+   static constexpr int CRITERIA_SAMPLE_MIN_ROWS = 2 * CRITERIA_SAMPLE_ROWS;
+
+   namespace
+   {
+      // Drops the points of the sampled rows.
+      struct discard_reporter_t
+      {
+         void report_point(const vertex_t&) { }
+      };
+
+      // Stops the scan of a sampled row once enough rejected points are kept.
+      struct sample_interruptor_t : interruptor_t
+      {
+         sample_interruptor_t(const std::vector<std::uint64_t>& some_masks, interruptor_t& an_interruptor)
+            : masks(some_masks), interruptor(an_interruptor) { }
+
+         bool interrupted() override
+         {
+            if (masks.size() >= CRITERIA_SAMPLE_ROW_POINTS)
+               return true;
+            is_interrupted = interruptor.interrupted();
+            return is_interrupted;
+         }
+
+         const std::vector<std::uint64_t>&   masks;
+         interruptor_t&                      interruptor;
+         bool                                is_interrupted = false;
+      };
+   }
+
+   void tiling_t::order_criteria(double tiling_bounds[2][MAX_DIM], const int bounds[2][MAX_DIM], interruptor_t& an_interruptor)
+   {
+      int criteria[MAX_CYLR_COMB];
+      for (int crit_index = 0; crit_index < my_cylinder_criteria_count; ++crit_index)
+         criteria[crit_index] = crit_index;
+
+      if (my_criteria_order == criteria_order_t::fixed)
+      {
+         if (my_is_criteria_order_sampled)
+            fill_cylinder_columns(criteria);
+         my_is_criteria_order_sampled = false;
+         return;
+      }
+
+      const int row_coord = my_coordinate_orders[0];
+      const int first_row = bounds[0][row_coord];
+      const int row_count = bounds[1][row_coord] - first_row + 1;
+      if (my_is_criteria_order_sampled || row_count < CRITERIA_SAMPLE_MIN_ROWS)
+         return;
+
+      // Sample rows spread over the scan, in the fixed order so that each
+      // rejected point records all the criteria rejecting it.
+
+      fill_cylinder_columns(criteria);
+
+      std::vector<std::uint64_t> masks;
+      generate_stats_t sample_stats;
+      discard_reporter_t discard;
+      std::vector<std::uint64_t> row_masks;
+      row_masks.reserve(CRITERIA_SAMPLE_ROW_POINTS);
+      for (int sample = 0; sample < CRITERIA_SAMPLE_ROWS; ++sample)
+      {
+         const int row = first_row + (2 * sample + 1) * row_count / (2 * CRITERIA_SAMPLE_ROWS);
+         sample_interruptor_t sample_interruptor(row_masks, an_interruptor);
+         dispatch_dimension(my_dimensions_count, [&]<int DIM>()
+         {
+            return scan_row<DIM>(tiling_bounds, bounds, row, discard, sample_interruptor, sample_stats, &row_masks);
+         });
+         if (sample_interruptor.is_interrupted)
+            return;
+         masks.insert(masks.end(), row_masks.begin(), row_masks.end());
+         row_masks.clear();
+      }
+
+      // Count identical sets of rejecting criteria once.
+
+      std::sort(masks.begin(), masks.end());
+      std::vector<std::pair<std::uint64_t, std::uint64_t>> counted_masks;
+      for (const std::uint64_t mask : masks)
+      {
+         if (counted_masks.empty() || counted_masks.back().first != mask)
+            counted_masks.emplace_back(mask, 0);
+         ++counted_masks.back().second;
+      }
+
+      // Greedily pick the criterion rejecting the most points not yet
+      // rejected. Ties and the criteria rejecting none keep the fixed order.
+
+      std::uint64_t remaining = 0;
+      for (int crit_index = 0; crit_index < my_cylinder_criteria_count; ++crit_index)
+         remaining |= std::uint64_t(1) << crit_index;
+
+      int ordered_count = 0;
+      while (!counted_masks.empty())
+      {
+         std::uint64_t rejects[MAX_CYLR_COMB] = { };
+         for (const auto& [mask, count] : counted_masks)
+            for (std::uint64_t bits = mask; bits; bits &= bits - 1)
+               rejects[std::countr_zero(bits)] += count;
+
+         int best = -1;
+         for (int crit_index = 0; crit_index < my_cylinder_criteria_count; ++crit_index)
+            if ((remaining >> crit_index) & 1)
+               if (best < 0 || rejects[crit_index] > rejects[best])
+                  best = crit_index;
+
+         criteria[ordered_count++] = best;
+         remaining &= ~(std::uint64_t(1) << best);
+
+         const std::uint64_t best_bit = std::uint64_t(1) << best;
+         std::erase_if(counted_masks, [best_bit](const auto& a_counted_mask) { return (a_counted_mask.first & best_bit) != 0; });
+      }
+
+      for (int crit_index = 0; crit_index < my_cylinder_criteria_count; ++crit_index)
+         if ((remaining >> crit_index) & 1)
+            criteria[ordered_count++] = crit_index;
+
+      fill_cylinder_columns(criteria);
+      my_is_criteria_order_sampled = true;
+   }
+
    // Initialize the tiling my_coordinate_orders[]. Sort my_coordinate_orders[] wrt the size of the
    // projections of the lattice generators to each of the plane
    // generators.
@@ -464,7 +643,7 @@ namespace dak::quasitiler
 
    // Find a bounding box for the cylinder in the ambient space.
    // bounds[] is a bounding box of the plane in generators coords.
-   void tiling_t::compute_ambient_bounds(double tiling_bounds[2][MAX_DIM], int bounds[2][MAX_DIM])
+   void tiling_t::compute_ambient_bounds(double tiling_bounds[2][MAX_DIM], int bounds[2][MAX_DIM]) const
    {
       double corner[2][2][MAX_DIM];
 
@@ -506,11 +685,24 @@ namespace dak::quasitiler
    }
 
 
+   // Find the bounds of all the lattice points that the scan can report.
+   void tiling_t::compute_lattice_bounds(const int bounds[2][MAX_DIM], int lattice_bounds[2][MAX_DIM]) const
+   {
+      static constexpr int margin = 3;
+
+      for (int ind = 0; ind < MAX_DIM; ++ind)
+      {
+         const bool is_active = (ind < my_dimensions_count);
+         lattice_bounds[0][ind] = is_active ? bounds[0][ind] - margin : 0;
+         lattice_bounds[1][ind] = is_active ? bounds[1][ind] + margin : 0;
+      }
+   }
+
    // Find a point in the tiling plane.  The plane is parametrized by
    // the two main canonical directions.  Use these two main directions
    // in scan_index to determine the point in the plane.  Return the
    // result both in the ambient space coords and the plane coords
-   void tiling_t::do_parametrization(const vertex_t& scan_index, double plane_point[], tiling_point_t& tiling_point)
+   void tiling_t::do_parametrization(const vertex_t& scan_index, double plane_point[], tiling_point_t& tiling_point) const
    {
       for (int ind0 = 0; ind0 < my_dimensions_count; ++ind0)
          plane_point[ind0] = offset[ind0];
@@ -539,7 +731,7 @@ namespace dak::quasitiler
 
    // Returns false if the point is not EPSILON inside the cylinder,
    // true otherwise.
-   bool tiling_t::in_cylinder(const vertex_t point)
+   bool tiling_t::in_cylinder(const vertex_t point) const
    {
       // Translate by the offset.
 
@@ -549,19 +741,102 @@ namespace dak::quasitiler
 
       // Now check if the point is inside all the faces of the cylinder.
 
-      for (int ind = 0; ind < my_cylinder_criteria_count; ++ind)
+      return my_cylinder_kernel->contains(my_cylinder_columns, trans_point, EPSILON);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Tests of the points of the scan.
+
+   bool tiling_t::in_window_shell(const vertex_t& a_point, generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const
+   {
+      const bool is_inside = in_cylinder(a_point);
+
+      if constexpr (STATS_ENABLED)
       {
-         // Compute the dot product.  For efficiency, no function call.
-
-         double dot_p = 0.0f;
-         double* current_criteria = my_cylinder_criteria[ind];
-         for (int ind1 = 0; ind1 < my_dimensions_count; ++ind1)
-            dot_p += current_criteria[ind1] * trans_point[ind1];
-         double ans = 1.0f - std::abs(dot_p);
-         if (ans < EPSILON) return false;  // outside.
+         ++some_stats.criteria_tests;
+         ++some_stats.exact_tests;
+         some_stats.criteria_rejects += !is_inside;
       }
 
-      return true;
+      if (is_inside || !(STATS_ENABLED || some_reject_masks))
+         return is_inside;
+
+      record_criteria_reject(a_point, some_stats, some_reject_masks);
+      return false;
+   }
+
+   // Margin around the faces where the running values are not trusted.
+   static constexpr double ROUNDING_MARGIN = 1e-9;
+
+   bool tiling_t::in_running_criteria(const vertex_t& a_point, const double some_values[], generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const
+   {
+      constexpr double inside_limit = 1.0 - EPSILON - ROUNDING_MARGIN;
+      constexpr double outside_limit = 1.0 - EPSILON + ROUNDING_MARGIN;
+
+      bool is_inside = false;
+      switch (my_cylinder_kernel->classify(my_cylinder_columns, some_values, inside_limit, outside_limit))
+      {
+         case cylinder_kernel_t::position_t::inside:
+            is_inside = true;
+            break;
+         case cylinder_kernel_t::position_t::outside:
+            is_inside = false;
+            break;
+         default:
+            is_inside = in_cylinder(a_point);
+            if constexpr (STATS_ENABLED)
+               ++some_stats.exact_tests;
+            break;
+      }
+
+      if constexpr (STATS_ENABLED)
+      {
+         ++some_stats.criteria_tests;
+         some_stats.criteria_rejects += !is_inside;
+      }
+
+      if (is_inside || !(STATS_ENABLED || some_reject_masks))
+         return is_inside;
+
+      record_criteria_reject(a_point, some_stats, some_reject_masks);
+      return false;
+   }
+
+   void tiling_t::record_criteria_reject(const vertex_t& a_point, generate_stats_t& some_stats, std::vector<std::uint64_t>* some_reject_masks) const
+   {
+      const bool is_sampled = some_reject_masks && some_reject_masks->size() < CRITERIA_SAMPLE_ROW_POINTS;
+      if (!(STATS_ENABLED || is_sampled))
+         return;
+
+      // Find the criteria rejecting the point, with their exact values.
+
+      double trans_point[MAX_DIM];
+      for (int ind1 = 0; ind1 < my_dimensions_count; ++ind1)
+         trans_point[ind1] = a_point.coords[ind1] - offset[ind1];
+
+      alignas(32) double values[cylinder_columns_t::MAX_PADDED_CRITERIA];
+      my_cylinder_kernel->evaluate(my_cylinder_columns, trans_point, values);
+
+      std::uint64_t mask = 0;
+      for (int crit_index = 0; crit_index < my_cylinder_criteria_count; ++crit_index)
+         if (1.0 - std::abs(values[crit_index]) < EPSILON)
+            mask |= std::uint64_t(1) << crit_index;
+
+      if constexpr (STATS_ENABLED)
+         if (mask)
+            ++some_stats.criterion_rejects[std::countr_zero(mask)];
+
+      if (is_sampled)
+         some_reject_masks->emplace_back(mask);
+   }
+
+   void tiling_t::reset_generate_stats()
+   {
+      const double init_seconds = my_generate_stats.init_seconds;
+      my_generate_stats = generate_stats_t();
+      my_generate_stats.init_seconds = init_seconds;
+      my_generate_stats.criteria_count = my_cylinder_criteria_count;
    }
 
    // generate() computes the vertices of the tiling that fit inside
@@ -580,97 +855,131 @@ namespace dak::quasitiler
 
    bool tiling_t::generate(double tiling_bounds[2][MAX_DIM], point_reporter_t& reporter, interruptor_t& an_interruptor)
    {
-      my_is_generated = false;
+      point_batch_t batch(reporter);
+      const bool is_done = scan_rows(tiling_bounds, batch, an_interruptor);
+      batch.flush();
+      return is_done;
+   }
 
-      // Find the bounds relative to the ambient space, for the bounds
-      // in the tiling subspace in.
+   namespace
+   {
+      // Keeps the points of one row until they can be reported in order.
+      struct row_buffer_t
+      {
+         std::vector<vertex_t>   points;
+
+         void report_point(const vertex_t& a_point)
+         {
+            points.emplace_back(a_point);
+         }
+      };
+   }
+
+   bool tiling_t::generate(double tiling_bounds[2][MAX_DIM], point_reporter_t& reporter, interruptor_t& an_interruptor, int a_thread_count)
+   {
+      my_is_generated = false;
 
       int bounds[2][MAX_DIM];
       compute_ambient_bounds(tiling_bounds, bounds);
 
-      // Initialize the indices for the scaning of this tiling.
-
-      vertex_t scan_index;
-      for (int ind = 0; ind < TARGET_DIM; ++ind)
-         scan_index.coords[my_coordinate_orders[ind]] = bounds[0][my_coordinate_orders[ind]];
+      const int row_coord = my_coordinate_orders[0];
+      const int first_row = bounds[0][row_coord];
+      const int row_count = std::max(0, bounds[1][row_coord] - first_row + 1);
 
-      // Scaning this tiling.
+      a_thread_count = std::min(get_thread_count(a_thread_count), row_count);
 
-      double diag = sqrt(2.0);
-      double plane_point[MAX_DIM];
-      tiling_point_t tiling_point;
-      while (scan_index.coords[my_coordinate_orders[0]] <= bounds[1][my_coordinate_orders[0]])
+      if (a_thread_count <= 1)
       {
-         // Find the next point in the tiling my_parametrization.
+         point_batch_t batch(reporter);
+         const bool is_done = scan_rows(tiling_bounds, batch, an_interruptor);
+         batch.flush();
+         return is_done;
+      }
 
-         do_parametrization(scan_index, plane_point, tiling_point);
+      reset_generate_stats();
+      stats_timer_t timer(my_generate_stats.generate_seconds);
 
-         // Do some preliminary clipping here.
+      order_criteria(tiling_bounds, bounds, an_interruptor);
+      report_bounds(bounds, reporter);
 
-         if (tiling_point.x > (tiling_bounds[0][0] - 2.0f)
-            && tiling_point.x < (tiling_bounds[1][0] + 2.0f)
-            && tiling_point.y >(tiling_bounds[0][1] - 2.0f)
-            && tiling_point.y < (tiling_bounds[1][1] + 2.0f))
-         {
-            // Find the bounds for the intersection of the tiling's
-            // plane with the remaining coordinates.
+      // Each row is scanned in its own buffer, and each thread keeps its
+      // own statistics, merged once all are done. The calling thread is
+      // the only one calling the reporter.
+      std::vector<row_buffer_t> rows(row_count);
+      std::vector<generate_stats_t> thread_stats(a_thread_count);
 
-            int local_bounds[2][MAX_DIM];
-            for (int dim = TARGET_DIM; dim < my_dimensions_count; ++dim)
+      const bool is_done = run_ordered(a_thread_count, row_count, an_interruptor,
+         [&](int a_thread_index, size_t a_row, interruptor_t& a_stop)
+         {
+            return dispatch_dimension(my_dimensions_count, [&]<int DIM>()
             {
-               local_bounds[0][my_coordinate_orders[dim]] = my_ceil(plane_point[my_coordinate_orders[dim]] - diag);
-               local_bounds[1][my_coordinate_orders[dim]] = my_floor(plane_point[my_coordinate_orders[dim]] + diag);
-            }
+               return scan_row<DIM>(tiling_bounds, bounds, first_row + int(a_row), rows[a_row], a_stop, thread_stats[a_thread_index]);
+            });
+         },
+         [&](size_t a_row)
+         {
+            // Report the row in order and release its memory.
+            if (!rows[a_row].points.empty())
+               reporter.report_points(rows[a_row].points);
+            std::vector<vertex_t>().swap(rows[a_row].points);
+         });
 
-            // Scan for all the intersecting points above the current
-            // plane_point.
+      if constexpr (STATS_ENABLED)
+         for (const generate_stats_t& stats : thread_stats)
+            my_generate_stats += stats;
 
-            for (int ind = TARGET_DIM; ind < my_dimensions_count; ++ind)
-               scan_index.coords[my_coordinate_orders[ind]] = local_bounds[0][my_coordinate_orders[ind]];
+      if (!is_done)
+         return false;
 
-            // Scaning.
+      my_is_generated = true;
+      return true;
+   }
 
-            while (scan_index.coords[my_coordinate_orders[TARGET_DIM]] <= local_bounds[1][my_coordinate_orders[TARGET_DIM]])
-            {
-               if (in_cylinder(scan_index))
-                  reporter.report_point(scan_index);
-
-               // Increment the scan_index to the next point.
-
-               int ind = my_dimensions_count - 1;
-               while ((++(scan_index.coords[my_coordinate_orders[ind]])) > local_bounds[1][my_coordinate_orders[ind]]
-                  && ind > TARGET_DIM)
-               {
-                  scan_index.coords[my_coordinate_orders[ind]] = local_bounds[0][my_coordinate_orders[ind]];
-                  ind--;
-               }
-            }
-         }
+   vertex_generator_t tiling_t::vertices(const double tiling_bounds[2][MAX_DIM])
+   {
+      plane_bounds_t plane_bounds;
+      for (int side = 0; side < 2; ++side)
+         for (int dim = 0; dim < MAX_DIM; ++dim)
+            plane_bounds.bounds[side][dim] = tiling_bounds[side][dim];
 
-         // Find the next point in the scaning in the my_parametrization.
+      return generate_vertices(plane_bounds);
+   }
 
-         int ind = TARGET_DIM - 1;
-         while ((++(scan_index.coords[my_coordinate_orders[ind]]))
-            > bounds[1][my_coordinate_orders[ind]] && ind > 0)
-         {
-            scan_index.coords[my_coordinate_orders[ind]] = bounds[0][my_coordinate_orders[ind]];
-            ind--;
-         }
+   vertex_generator_t tiling_t::generate_vertices(plane_bounds_t some_bounds)
+   {
+      my_is_generated = false;
+      reset_generate_stats();
 
-         // Should we abort the computation.
+      int bounds[2][MAX_DIM];
+      compute_ambient_bounds(some_bounds.bounds, bounds);
 
-         if (an_interruptor.interrupted())
-            return false;
+      // The consumer stops by not taking more points.
+      stop_flag_t never_stopped;
+
+      order_criteria(some_bounds.bounds, bounds, never_stopped);
+
+      // Scan a row only once all the points of the previous one were taken.
+
+      const int row_coord = my_coordinate_orders[0];
+      row_buffer_t row_buffer;
+      for (int row = bounds[0][row_coord]; row <= bounds[1][row_coord]; ++row)
+      {
+         row_buffer.points.clear();
+         dispatch_dimension(my_dimensions_count, [&]<int DIM>()
+         {
+            return scan_row<DIM>(some_bounds.bounds, bounds, row, row_buffer, never_stopped, my_generate_stats);
+         });
+
+         for (const vertex_t& point : row_buffer.points)
+            co_yield point;
       }
 
       my_is_generated = true;
-      return true;
    }
 
-
    // Now we define elementary vector operations.
 
-   double tiling_t::dot_product(double x[], double y[])
+   double tiling_t::dot_product(const double x[], const double y[]) const
    {
       double prod = 0.0f;
 
@@ -680,14 +989,14 @@ namespace dak::quasitiler
    }
 
    // Computes x = s * y
-   void tiling_t::scalar_mult(double x[], double s, double y[])
+   void tiling_t::scalar_mult(double x[], double s, const double y[]) const
    {
       for (int ind = my_dimensions_count; --ind >= 0; )
          x[ind] = s * y[ind];
    }
 
    // Computes x = x + s * y
-   void tiling_t::add_to(double x[], double s, double y[])
+   void tiling_t::add_to(double x[], double s, const double y[]) const
    {
       for (int ind = my_dimensions_count; --ind >= 0; )
          x[ind] += s * y[ind];
@@ -0,0 +1,74 @@
+#include <dak/quasitiler/vertex_index.h>
+#include <dak/quasitiler/parallel.h>
+
+#include <algorithm>
+
+
+namespace dak::quasitiler
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vertex slots.
+
+   void vertex_slots_t::allocate(size_t a_count)
+   {
+      size_t capacity = 16;
+      my_shift = 60;
+      while (capacity < a_count * 2)
+      {
+         capacity *= 2;
+         my_shift -= 1;
+      }
+
+      my_mask = capacity - 1;
+      my_slots.assign(capacity, EMPTY);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Vertex index.
+
+   // The fewest vertices worth giving to each thread.
+   static constexpr size_t MIN_INDEX_THREAD_COUNT = 64 * 1024;
+
+   vertex_index_t::vertex_index_t(const std::vector<vertex_t>& some_vertices, int a_dimensions_count, int a_thread_count)
+      : my_vertices(&some_vertices), my_slots(a_dimensions_count)
+   {
+      my_slots.allocate(some_vertices.size());
+      insert_all(some_vertices, a_thread_count);
+   }
+
+   vertex_index_t::vertex_index_t(const std::vector<uint64_t>& some_keys, int a_thread_count)
+      : my_keys(&some_keys)
+   {
+      my_slots.allocate(some_keys.size());
+      insert_all(some_keys, a_thread_count);
+   }
+
+   template <class KEY>
+   void vertex_index_t::insert_all(const std::vector<KEY>& some_keys, int a_thread_count)
+   {
+      a_thread_count = (int)std::clamp<size_t>(some_keys.size() / MIN_INDEX_THREAD_COUNT, 1, get_thread_count(a_thread_count));
+
+      // Keep the first of duplicated vertices.
+      if (a_thread_count <= 1)
+      {
+         for (size_t key_index = 0; key_index < some_keys.size(); ++key_index)
+         {
+            size_t& slot = my_slots.probe(some_keys, some_keys[key_index]);
+            if (slot == vertex_slots_t::EMPTY)
+               slot = key_index;
+         }
+         return;
+      }
+
+      // Each thread inserts a slice of the vertices in the shared slots.
+      run_threads(a_thread_count, [&](int a_thread_index)
+      {
+         const size_t begin = some_keys.size() * a_thread_index / a_thread_count;
+         const size_t end = some_keys.size() * (a_thread_index + 1) / a_thread_count;
+         for (size_t key_index = begin; key_index < end; ++key_index)
+            my_slots.insert_shared(some_keys, key_index);
+      });
+   }
+}
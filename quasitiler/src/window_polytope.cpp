@@ -0,0 +1,211 @@
+#include <dak/quasitiler/window_polytope.h>
+
+#include <cmath>
+#include <algorithm>
+#include <bit>
+
+
+namespace dak::quasitiler
+{
+   // Vectors shorter than this are considered null, and points closer than
+   // this to a facet are considered on it.
+   static constexpr double ZERO_MARGIN = 1e-9;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Constructor.
+
+   window_polytope_t::window_polytope_t(const double some_columns[MAX_DIM][WINDOW_DIM], int a_dimensions_count)
+      : my_dimensions_count(a_dimensions_count), my_window_dimensions_count(a_dimensions_count - 2)
+   {
+      for (int ind = 0; ind < my_dimensions_count; ++ind)
+         for (int dim = 0; dim < my_window_dimensions_count; ++dim)
+            my_columns[ind].coords[dim] = some_columns[ind][dim];
+
+      compute_facets();
+      compute_vertices();
+
+      my_inner_radius = my_facets.empty() ? 0. : my_facets[0].distance;
+      for (const facet_t& facet : my_facets)
+         my_inner_radius = std::min(my_inner_radius, facet.distance);
+
+      my_outer_radius = 0.;
+      for (const point_t& vertex : my_vertices)
+         my_outer_radius = std::max(my_outer_radius, std::sqrt(dot_product(vertex, vertex)));
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Construction of the window.
+
+   void window_polytope_t::compute_facets()
+   {
+      const int window_count = my_window_dimensions_count;
+
+      for (int subset = 0; subset < (1 << my_dimensions_count); ++subset)
+      {
+         if (std::popcount(unsigned(subset)) != window_count - 1)
+            continue;
+
+         // Orthonormal basis of the span of the generators of the subset.
+         // They must be independent to be parallel to a facet.
+
+         point_t basis[WINDOW_DIM];
+         int rank = 0;
+         for (int ind = 0; ind < my_dimensions_count; ++ind)
+         {
+            if (!((subset >> ind) & 1))
+               continue;
+
+            point_t vector = my_columns[ind];
+            for (int base = 0; base < rank; ++base)
+            {
+               const double projection = dot_product(vector, basis[base]);
+               for (int dim = 0; dim < window_count; ++dim)
+                  vector.coords[dim] -= projection * basis[base].coords[dim];
+            }
+
+            const double norm = std::sqrt(dot_product(vector, vector));
+            if (norm < ZERO_MARGIN)
+               break;
+            for (int dim = 0; dim < window_count; ++dim)
+               vector.coords[dim] /= norm;
+            basis[rank++] = vector;
+         }
+
+         if (rank != window_count - 1)
+            continue;
+
+         // The normal is what remains of the canonical vector
+         // the furthest from the span once projected out.
+
+         point_t normal;
+         double normal_norm = 0.;
+         for (int axis = 0; axis < window_count; ++axis)
+         {
+            point_t residual;
+            residual.coords[axis] = 1.;
+            for (int base = 0; base < rank; ++base)
+            {
+               const double projection = basis[base].coords[axis];
+               for (int dim = 0; dim < window_count; ++dim)
+                  residual.coords[dim] -= projection * basis[base].coords[dim];
+            }
+
+            const double norm = std::sqrt(dot_product(residual, residual));
+            if (norm > normal_norm)
+            {
+               normal = residual;
+               normal_norm = norm;
+            }
+         }
+
+         for (int dim = 0; dim < window_count; ++dim)
+            normal.coords[dim] /= normal_norm;
+
+         // Each generator extends the window by half its length along the normal.
+
+         double distance = 0.;
+         for (int ind = 0; ind < my_dimensions_count; ++ind)
+            distance += std::abs(dot_product(normal, my_columns[ind])) * 0.5;
+         if (distance < ZERO_MARGIN)
+            continue;
+
+         // Subsets whose generators span the same hyperplane give the same facets.
+
+         const bool is_known = std::any_of(my_facets.begin(), my_facets.end(), [&](const facet_t& a_facet)
+         {
+            return std::abs(dot_product(a_facet.normal, normal)) > 1. - ZERO_MARGIN;
+         });
+         if (is_known)
+            continue;
+
+         int positives = 0;
+         int negatives = 0;
+         for (int ind = 0; ind < my_dimensions_count; ++ind)
+         {
+            const double along = dot_product(normal, my_columns[ind]);
+            if (along > ZERO_MARGIN)
+               positives |= 1 << ind;
+            else if (along < -ZERO_MARGIN)
+               negatives |= 1 << ind;
+         }
+
+         facet_t facet;
+         facet.normal = normal;
+         facet.distance = distance;
+         my_facets.emplace_back(facet);
+         my_facet_signs.emplace_back(positives, negatives);
+
+         for (int dim = 0; dim < window_count; ++dim)
+            facet.normal.coords[dim] = -normal.coords[dim];
+         my_facets.emplace_back(facet);
+         my_facet_signs.emplace_back(negatives, positives);
+      }
+   }
+
+   void window_polytope_t::compute_vertices()
+   {
+      // The points of the window furthest along the normal of a facet have
+      // the coordinate of each generator at the end given by the sign of the
+      // generator along the normal, or anywhere when the generator is parallel
+      // to the facet. So a projected cube corner is on the facets whose signs
+      // it matches.
+      //
+      // The corner is a vertex when it is the only point of the window
+      // furthest along some direction. The sum of the normals of the facets
+      // it is on is such a direction: the corner must then have each
+      // coordinate on the side of the generator along that direction.
+
+      std::vector<int> facets;
+      for (int corner = 0; corner < (1 << my_dimensions_count); ++corner)
+      {
+         facets.clear();
+         point_t direction;
+         for (int facet_index = 0; facet_index < (int)my_facets.size(); ++facet_index)
+         {
+            const auto [positives, negatives] = my_facet_signs[facet_index];
+            if ((corner & (positives | negatives)) != positives)
+               continue;
+
+            facets.emplace_back(facet_index);
+            for (int dim = 0; dim < my_window_dimensions_count; ++dim)
+               direction.coords[dim] += my_facets[facet_index].normal.coords[dim];
+         }
+
+         bool is_vertex = !facets.empty();
+         for (int ind = 0; ind < my_dimensions_count && is_vertex; ++ind)
+         {
+            const double along = dot_product(direction, my_columns[ind]);
+            is_vertex = ((corner >> ind) & 1) ? along > ZERO_MARGIN : along < -ZERO_MARGIN;
+         }
+
+         if (!is_vertex)
+            continue;
+
+         point_t point;
+         for (int ind = 0; ind < my_dimensions_count; ++ind)
+         {
+            const double half = ((corner >> ind) & 1) ? 0.5 : -0.5;
+            for (int dim = 0; dim < my_window_dimensions_count; ++dim)
+               point.coords[dim] += half * my_columns[ind].coords[dim];
+         }
+
+         for (int facet_index : facets)
+            my_facets[facet_index].vertices.emplace_back((int)my_vertices.size());
+         my_vertices.emplace_back(point);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Utility functions.
+
+   double window_polytope_t::dot_product(const point_t& a_point, const point_t& an_other) const
+   {
+      double product = 0.;
+      for (int dim = 0; dim < my_window_dimensions_count; ++dim)
+         product += a_point.coords[dim] * an_other.coords[dim];
+      return product;
+   }
+}
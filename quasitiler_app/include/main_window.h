@@ -5,6 +5,7 @@
 
 #include <dak/quasitiler/tiling.h>
 #include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/drawing_cache.h>
 #include <dak/quasitiler/interruptor.h>
 
 #include <dak/ui/qt/function_drawing_canvas.h>
@@ -93,10 +94,10 @@ namespace dak::quasitiler_app
       void showException(const char* message, const std::exception& ex);
 
    signals:
-      void generate_tiling_done(drawing_t* a_drawing);
+      void generate_tiling_done(std::shared_ptr<const drawing_t> a_drawing);
 
    private slots:
-      void handle_generated_tiling(drawing_t* a_drawing);
+      void handle_generated_tiling(std::shared_ptr<const drawing_t> a_drawing);
 
    private:
       // Toolbar buttons.
@@ -148,17 +149,21 @@ namespace dak::quasitiler_app
 
       int            my_tile_size = 30;
 
-      std::shared_ptr<tiling_t>     my_tiling;
-      std::shared_ptr<drawing_t>    my_drawing;
+      std::shared_ptr<tiling_t>           my_tiling;
+      std::shared_ptr<const drawing_t>    my_drawing;
+      quasitiler::drawing_cache_t         my_drawing_cache;
 
-      int                           my_dimensions_count = 5;
+      int                                 my_dimensions_count = 5;
 
-      std::future<int>              my_async_generating;
-      std::atomic<bool>             my_stop_generating = false;
+      std::future<int>                    my_async_generating;
+      std::atomic<bool>                   my_stop_generating = false;
       
       Q_OBJECT;
    };
 }
 
+// The generated drawing is sent between threads.
+Q_DECLARE_METATYPE(std::shared_ptr<const dak::quasitiler::drawing_t>)
+
 #endif /* DAK_QUASITILER_APP_MAIN_WINDOW_H */
 
@@ -1,6 +1,7 @@
 #include <main_window.h>
 #include <dimension_editor.h>
 #include <tile_group_editor.h>
+#include <dak/quasitiler/tile_colors.h>
 
 #include <dak/ui/qt/convert.h>
 
@@ -243,39 +244,26 @@ namespace dak::quasitiler_app
    //
    // Draw tiling.
 
+   // Conversions between UI colors and the 0xRRGGBB colors of the tiling library.
+   static ui::color_t to_color(std::uint32_t a_rgb)
+   {
+      return ui::color_t((a_rgb >> 16) & 0xFF, (a_rgb >> 8) & 0xFF, a_rgb & 0xFF);
+   }
+
+   static std::uint32_t to_rgb(ui::color_t a_color)
+   {
+      return (std::uint32_t(a_color.r) << 16) | (std::uint32_t(a_color.g) << 8) | std::uint32_t(a_color.b);
+   }
+
    void main_window_t::create_color_table()
    {
       // Init color table.
+      quasitiler::tile_group_colors_t colors;
+      quasitiler::get_default_tile_group_colors(colors);
       for (int row = 0; row < sizeof(my_color_table) / sizeof(my_color_table[0]); ++row)
       {
-         int v = 255 - (row / 6) * 15;
-         switch (row % 6)
-         {
-         case 0:
-            my_color_table[row][0] = ui::color_t(v, 80, 80);
-            my_color_table[row][1] = ui::color_t(80, 80, v);
-            break;
-         case 1:
-            my_color_table[row][0] = ui::color_t(80, v, 80);
-            my_color_table[row][1] = ui::color_t(80, v, v);
-            break;
-         case 2:
-            my_color_table[row][0] = ui::color_t(v, 80, v);
-            my_color_table[row][1] = ui::color_t(v, v, 80);
-            break;
-         case 3:
-            my_color_table[row][0] = ui::color_t(v, v / 2, 0);
-            my_color_table[row][1] = ui::color_t(0, v / 2, v);
-            break;
-         case 4:
-            my_color_table[row][0] = ui::color_t(v / 2, v, 0);
-            my_color_table[row][1] = ui::color_t(0, v, v / 2);
-            break;
-         case 5:
-            my_color_table[row][0] = ui::color_t(v, 0, v / 2);
-            my_color_table[row][1] = ui::color_t(v, v / 2, 0);
-            break;
-         }
+         my_color_table[row][0] = to_color(colors[row][0]);
+         my_color_table[row][1] = to_color(colors[row][1]);
       }
    }
 
@@ -307,32 +295,10 @@ namespace dak::quasitiler_app
       if (!my_tiling)
          return ui::color_t(0, 0, 0);
 
-      const int row = tile_index / my_dimensions_count;
-      const int col = tile_index % my_dimensions_count;
-
-      int row_count;
-      if (row >= my_dimensions_count / 2 - 1
-              && my_dimensions_count % 2 == 0)
-      {
-         row_count = my_dimensions_count / 2 - 1;
-      }
-      else
-      {
-         row_count = my_dimensions_count - 1;
-      }
-
       // Interpolate color.
 
-      const double cof = (double)col / (double)row_count;
-      const double cof_complement = 1. - cof;
-
-      const ui::color_t leftColor  = get_color(row, 0);
-      const ui::color_t rightColor = get_color(row, 1);
-      return ui::color_t(
-         (int)(cof_complement * leftColor.r + cof * rightColor.r),
-         (int)(cof_complement * leftColor.g + cof * rightColor.g),
-         (int)(cof_complement * leftColor.b + cof * rightColor.b));
-
+      const int row = quasitiler::get_tile_color_group(tile_index, my_dimensions_count);
+      return to_color(quasitiler::interpolate_tile_color(tile_index, my_dimensions_count, to_rgb(get_color(row, 0)), to_rgb(get_color(row, 1))));
    }
 
    void main_window_t::draw_tiling()
@@ -357,20 +323,14 @@ namespace dak::quasitiler_app
       // Get local for speed.
 
       const tiling_t tiling = *my_tiling;
-      const drawing_t drawing = *my_drawing;
+      const drawing_t& drawing = *my_drawing;
 
       const int dim = tiling.dimensions_count();
-      const size_t vertex_count = drawing.my_vertex_storage.size();
 
-      // Compute the projection of the lattice vertices.
-      using quasitiler::tiling_point_t;
+      // The projection of the lattice vertices, computed once per generation.
 
-      tiling_point_t* vertices = new tiling_point_t[vertex_count];
-
-      for (size_t ind = 0; ind < vertex_count; ind++)
-      {
-         drawing.lattice_to_tiling(drawing.my_vertex_storage[ind], vertices[ind]);
-      }
+      const double* vertices_x = drawing.get_tiling_points().xs.data();
+      const double* vertices_y = drawing.get_tiling_points().ys.data();
 
       // Premultiply the edge generators by their correct sign.
 
@@ -400,14 +360,14 @@ namespace dak::quasitiler_app
             for (size_t ind = 0; ind < my_tile_storage[comb].size(); ++ind)
             {
                const size_t vertex_index = my_tile_storage[comb][ind];
-               quad_x[0] = (int)(tile_size * (vertices[vertex_index].x));
-               quad_y[0] = (int)(tile_size * (vertices[vertex_index].y));
-               quad_x[1] = (int)(tile_size * (vertices[vertex_index].x + generator[gen0][0]));
-               quad_y[1] = (int)(tile_size * (vertices[vertex_index].y + generator[gen0][1]));
-               quad_x[2] = (int)(tile_size * (vertices[vertex_index].x + generator[gen0][0] + generator[gen1][0]));
-               quad_y[2] = (int)(tile_size * (vertices[vertex_index].y + generator[gen0][1] + generator[gen1][1]));
-               quad_x[3] = (int)(tile_size * (vertices[vertex_index].x + generator[gen1][0]));
-               quad_y[3] = (int)(tile_size * (vertices[vertex_index].y + generator[gen1][1]));
+               quad_x[0] = (int)(tile_size * (vertices_x[vertex_index]));
+               quad_y[0] = (int)(tile_size * (vertices_y[vertex_index]));
+               quad_x[1] = (int)(tile_size * (vertices_x[vertex_index] + generator[gen0][0]));
+               quad_y[1] = (int)(tile_size * (vertices_y[vertex_index] + generator[gen0][1]));
+               quad_x[2] = (int)(tile_size * (vertices_x[vertex_index] + generator[gen0][0] + generator[gen1][0]));
+               quad_y[2] = (int)(tile_size * (vertices_y[vertex_index] + generator[gen0][1] + generator[gen1][1]));
+               quad_x[3] = (int)(tile_size * (vertices_x[vertex_index] + generator[gen1][0]));
+               quad_y[3] = (int)(tile_size * (vertices_y[vertex_index] + generator[gen1][1]));
 
                ui::polygon_t polygon;
                polygon.points.push_back(ui::point_t(quad_x[0], quad_y[0]));
@@ -428,14 +388,14 @@ namespace dak::quasitiler_app
                for (size_t ind = 0; ind < my_tile_storage[comb].size(); ++ind)
                {
                   const size_t vertex_index = my_tile_storage[comb][ind];
-                  quad_x[0] = (int)(tile_size * (vertices[vertex_index].x));
-                  quad_y[0] = (int)(tile_size * (vertices[vertex_index].y));
-                  quad_x[1] = (int)(tile_size * (vertices[vertex_index].x + generator[gen0][0]));
-                  quad_y[1] = (int)(tile_size * (vertices[vertex_index].y + generator[gen0][1]));
-                  quad_x[2] = (int)(tile_size * (vertices[vertex_index].x + generator[gen0][0] + generator[gen1][0]));
-                  quad_y[2] = (int)(tile_size * (vertices[vertex_index].y + generator[gen0][1] + generator[gen1][1]));
-                  quad_x[3] = (int)(tile_size * (vertices[vertex_index].x + generator[gen1][0]));
-                  quad_y[3] = (int)(tile_size * (vertices[vertex_index].y + generator[gen1][1]));
+                  quad_x[0] = (int)(tile_size * (vertices_x[vertex_index]));
+                  quad_y[0] = (int)(tile_size * (vertices_y[vertex_index]));
+                  quad_x[1] = (int)(tile_size * (vertices_x[vertex_index] + generator[gen0][0]));
+                  quad_y[1] = (int)(tile_size * (vertices_y[vertex_index] + generator[gen0][1]));
+                  quad_x[2] = (int)(tile_size * (vertices_x[vertex_index] + generator[gen0][0] + generator[gen1][0]));
+                  quad_y[2] = (int)(tile_size * (vertices_y[vertex_index] + generator[gen0][1] + generator[gen1][1]));
+                  quad_x[3] = (int)(tile_size * (vertices_x[vertex_index] + generator[gen1][0]));
+                  quad_y[3] = (int)(tile_size * (vertices_y[vertex_index] + generator[gen1][1]));
 
                   ui::polygon_t polygon;
                   polygon.points.push_back(ui::point_t(quad_x[0], quad_y[0]));
@@ -525,13 +485,31 @@ namespace dak::quasitiler_app
          try
          {
             auto tiling = std::make_shared<tiling_t>(dim_count);
-            auto drawing = std::make_unique<drawing_t>(tiling);
-
             tiling->init(self->my_tiling_offsets);
-            tiling->generate(self->my_tiling_bounds, *drawing, *self);
-            drawing->locate_tiles(*self);
 
-            self->generate_tiling_done(drawing.release());
+            // Reuse the drawing if these parameters were already generated.
+
+            const quasitiler::drawing_key_t key(*tiling, self->my_tiling_bounds);
+            if (auto cached = self->my_drawing_cache.find(key, tiling))
+            {
+               self->generate_tiling_done(cached);
+               return 1;
+            }
+
+            auto drawing = std::make_shared<drawing_t>(tiling);
+            tiling->generate(self->my_tiling_bounds, *drawing, *self, 0);
+            const bool is_located = drawing->locate_tiles(*self, 0);
+
+            // Only cache complete drawings, not interrupted ones. Interrupted
+            // ones are still shown, so project their vertices, which locating
+            // the tiles only does once done.
+
+            if (tiling->is_generated() && is_located)
+               self->my_drawing_cache.insert(key, drawing);
+            else if (drawing->get_tiling_points().size() != drawing->my_vertex_storage.size())
+               drawing->project_vertices(0);
+
+            self->generate_tiling_done(drawing);
 
             return 1;
          }
@@ -542,10 +520,10 @@ namespace dak::quasitiler_app
       });
    }
 
-   void main_window_t::handle_generated_tiling(drawing_t* a_drawing)
+   void main_window_t::handle_generated_tiling(std::shared_ptr<const drawing_t> a_drawing)
    {
       my_tiling = a_drawing->get_tiling();
-      my_drawing.reset(a_drawing);
+      my_drawing = a_drawing;
 
       draw_tiling();
       update_toolbar();
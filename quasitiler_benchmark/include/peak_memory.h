@@ -0,0 +1,19 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_BENCHMARK_PEAK_MEMORY_H
+#define DAK_QUASITILER_BENCHMARK_PEAK_MEMORY_H
+
+#include <cstdint>
+
+
+namespace dak::quasitiler_benchmark
+{
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // The peak memory used by the process so far, in bytes, as reported by
+   // the operating system. Zero when unavailable.
+
+   std::uint64_t get_peak_memory();
+}
+
+#endif /* DAK_QUASITILER_BENCHMARK_PEAK_MEMORY_H */
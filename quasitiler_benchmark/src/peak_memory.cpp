@@ -0,0 +1,36 @@
+#include "peak_memory.h"
+
+#if defined(_WIN32)
+   #define WIN32_LEAN_AND_MEAN
+   #include <windows.h>
+   #include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+   #include <sys/resource.h>
+#endif
+
+
+namespace dak::quasitiler_benchmark
+{
+   std::uint64_t get_peak_memory()
+   {
+   #if defined(_WIN32)
+      PROCESS_MEMORY_COUNTERS counters = { };
+      if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+         return 0;
+      return counters.PeakWorkingSetSize;
+   #elif defined(__unix__) || defined(__APPLE__)
+      rusage usage = { };
+      if (getrusage(RUSAGE_SELF, &usage) != 0)
+         return 0;
+      #if defined(__APPLE__)
+         // Reported in bytes.
+         return std::uint64_t(usage.ru_maxrss);
+      #else
+         // Reported in kilobytes.
+         return std::uint64_t(usage.ru_maxrss) * 1024;
+      #endif
+   #else
+      return 0;
+   #endif
+   }
+}
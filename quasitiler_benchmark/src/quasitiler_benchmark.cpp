@@ -0,0 +1,376 @@
+#include <dak/quasitiler/tiling.h>
+#include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/interruptor.h>
+#include <dak/quasitiler/multigrid_drawing.h>
+#include <dak/quasitiler/stats.h>
+#include <dak/quasitiler/substitution_drawing.h>
+
+#include "peak_memory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace dak::quasitiler_benchmark
+{
+   using namespace dak::quasitiler;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Benchmark options and results.
+
+   // How the drawing is generated.
+   //
+   // scan: tiling_t::generate() then drawing_t::locate_tiles().
+   // multigrid: multigrid_drawing_t::generate(), timed as the generation.
+   // substitution: substitution_drawing_t::generate(), timed as the generation.
+   enum class engine_t
+   {
+      scan,
+      multigrid,
+      substitution,
+   };
+
+   static const char* engine_names[] = { "scan", "multigrid", "substitution" };
+
+   // How the vertices are ordered once located, as drawing_t::vertex_order_t.
+   static const char* vertex_order_names[] = { "located", "morton", "hilbert" };
+
+   struct options_t
+   {
+      std::vector<int>     dimensions = { 3, 4, 5, 6, 7, 8 };
+      std::vector<double>  sizes = { 10., 20., 40. };
+      int                  repeat = 3;
+      int                  thread_count = 1;
+      bool                 json = false;
+      bool                 stats = false;
+      bool                 adaptive = false;
+      engine_t             engine = engine_t::scan;
+      drawing_t::vertex_order_t vertex_order = drawing_t::vertex_order_t::located;
+   };
+
+   struct result_t
+   {
+      int            dimensions_count = 0;
+      double         size = 0.;
+      size_t         vertex_count = 0;
+      size_t         tile_count = 0;
+      double         init_seconds = 0.;
+      double         generate_seconds = 0.;
+      double         locate_seconds = 0.;
+      std::uint64_t  peak_memory = 0;
+
+      // Hot-path statistics of the last run, when the library records them.
+      generate_stats_t  generate_stats;
+      locate_stats_t    locate_stats;
+   };
+
+   // The canonical offsets. The first two are ignored by the tiling, since
+   // they are along the tiling plane.
+   static constexpr double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.13, 0.21, 0.34, 0.08, 0.17, 0.26 };
+
+   struct never_interrupted_t : interruptor_t
+   {
+      bool interrupted() override { return false; }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Benchmark one dimension and size. Each phase keeps its best time.
+
+   static bool run_case(const options_t& some_options, int a_dimensions_count, double a_size, result_t& a_result)
+   {
+      using clock_t = std::chrono::steady_clock;
+      auto seconds_since = [](clock_t::time_point a_start)
+      {
+         return std::chrono::duration<double>(clock_t::now() - a_start).count();
+      };
+
+      a_result.dimensions_count = a_dimensions_count;
+      a_result.size = a_size;
+
+      double bounds[2][tiling_t::MAX_DIM];
+      for (int ind = 0; ind < tiling_t::MAX_DIM; ++ind)
+      {
+         bounds[0][ind] = -a_size;
+         bounds[1][ind] = a_size;
+      }
+
+      never_interrupted_t never;
+      for (int run = 0; run < std::max(1, some_options.repeat); ++run)
+      {
+         double run_offsets[tiling_t::MAX_DIM];
+         std::copy(offsets, offsets + tiling_t::MAX_DIM, run_offsets);
+
+         auto tiling = std::make_shared<tiling_t>(a_dimensions_count);
+         if (some_options.adaptive)
+            tiling->set_criteria_order(tiling_t::criteria_order_t::adaptive);
+         auto start = clock_t::now();
+         if (!tiling->init(run_offsets))
+            return false;
+         const double init_seconds = seconds_since(start);
+
+         drawing_t drawing(tiling);
+         drawing.set_vertex_order(some_options.vertex_order);
+         double generate_seconds = 0.;
+         double locate_seconds = 0.;
+         if (some_options.engine == engine_t::multigrid)
+         {
+            multigrid_drawing_t multigrid(tiling);
+            start = clock_t::now();
+            if (!multigrid.generate(bounds, drawing, never))
+               return false;
+            generate_seconds = seconds_since(start);
+         }
+         else if (some_options.engine == engine_t::substitution)
+         {
+            substitution_drawing_t substitution(tiling);
+            start = clock_t::now();
+            if (!substitution.generate(bounds, drawing, never))
+               return false;
+            generate_seconds = seconds_since(start);
+         }
+         else
+         {
+            start = clock_t::now();
+            if (!tiling->generate(bounds, drawing, never, some_options.thread_count))
+               return false;
+            generate_seconds = seconds_since(start);
+
+            start = clock_t::now();
+            if (!drawing.locate_tiles(never, some_options.thread_count))
+               return false;
+            locate_seconds = seconds_since(start);
+         }
+
+         size_t tile_count = 0;
+         for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+            tile_count += drawing.get_tile_storage()[comb].size();
+
+         const bool is_first = (run == 0);
+         a_result.vertex_count = drawing.get_vertex_storage().size();
+         a_result.tile_count = tile_count;
+         a_result.init_seconds = is_first ? init_seconds : std::min(a_result.init_seconds, init_seconds);
+         a_result.generate_seconds = is_first ? generate_seconds : std::min(a_result.generate_seconds, generate_seconds);
+         a_result.locate_seconds = is_first ? locate_seconds : std::min(a_result.locate_seconds, locate_seconds);
+         a_result.generate_stats = tiling->get_generate_stats();
+         a_result.locate_stats = drawing.get_locate_stats();
+      }
+
+      // The peak is for the whole process, so it includes the previous cases.
+      a_result.peak_memory = get_peak_memory();
+
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Output.
+
+   static double per_second(size_t a_count, double some_seconds)
+   {
+      return some_seconds > 0. ? double(a_count) / some_seconds : 0.;
+   }
+
+   static void print_text(const std::vector<result_t>& some_results)
+   {
+      std::printf("%4s %6s %10s %10s %10s %12s %12s %14s %14s %10s\n",
+         "dim", "size", "vertices", "tiles", "init ms", "generate ms", "locate ms", "points/s", "tiles/s", "peak MB");
+      for (const result_t& result : some_results)
+      {
+         std::printf("%4d %6g %10zu %10zu %10.3f %12.3f %12.3f %14.0f %14.0f %10.1f\n",
+            result.dimensions_count, result.size, result.vertex_count, result.tile_count,
+            result.init_seconds * 1000., result.generate_seconds * 1000., result.locate_seconds * 1000.,
+            per_second(result.vertex_count, result.generate_seconds),
+            per_second(result.tile_count, result.locate_seconds),
+            double(result.peak_memory) / (1024. * 1024.));
+      }
+   }
+
+   static void print_stats(const std::vector<result_t>& some_results)
+   {
+      for (const result_t& result : some_results)
+      {
+         std::printf("\ndimension %d, size %g\n%s%s",
+            result.dimensions_count, result.size,
+            to_string(result.generate_stats).c_str(),
+            to_string(result.locate_stats).c_str());
+      }
+   }
+
+   static void print_json(const options_t& some_options, const std::vector<result_t>& some_results)
+   {
+      std::printf("{\n");
+      std::printf("  \"benchmark\": \"quasitiler\",\n");
+      std::printf("  \"format_version\": 1,\n");
+      std::printf("  \"repeat\": %d,\n", some_options.repeat);
+      std::printf("  \"thread_count\": %d,\n", some_options.thread_count);
+      std::printf("  \"cylinder_kernel\": \"%s\",\n", get_cylinder_kernel().name);
+      std::printf("  \"criteria_order\": \"%s\",\n", some_options.adaptive ? "adaptive" : "fixed");
+      std::printf("  \"engine\": \"%s\",\n", engine_names[int(some_options.engine)]);
+      std::printf("  \"vertex_order\": \"%s\",\n", vertex_order_names[int(some_options.vertex_order)]);
+      std::printf("  \"cases\": [\n");
+      for (size_t index = 0; index < some_results.size(); ++index)
+      {
+         const result_t& result = some_results[index];
+         std::printf("    { \"dimensions\": %d, \"size\": %g, \"vertices\": %zu, \"tiles\": %zu, "
+                     "\"init_seconds\": %.9f, \"generate_seconds\": %.9f, \"locate_seconds\": %.9f, "
+                     "\"points_per_second\": %.1f, \"tiles_per_second\": %.1f, \"peak_memory_bytes\": %llu }%s\n",
+            result.dimensions_count, result.size, result.vertex_count, result.tile_count,
+            result.init_seconds, result.generate_seconds, result.locate_seconds,
+            per_second(result.vertex_count, result.generate_seconds),
+            per_second(result.tile_count, result.locate_seconds),
+            (unsigned long long)result.peak_memory,
+            index + 1 < some_results.size() ? "," : "");
+      }
+      std::printf("  ]\n");
+      std::printf("}\n");
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Command-line.
+
+   static void print_usage(const char* a_program)
+   {
+      std::fprintf(stderr,
+         "Usage: %s [options]\n"
+         "\n"
+         "Time tiling_t::init(), tiling_t::generate() and drawing_t::locate_tiles()\n"
+         "on a canonical corpus of symmetric tilings with non-zero offsets.\n"
+         "\n"
+         "Options:\n"
+         "  --json              Print the results in JSON.\n"
+         "  --adaptive          Order the cylinder criteria adaptively.\n"
+         "  --engine NAME       How the drawing is generated: scan, the default,\n"
+         "                      multigrid, which locates the tiles as it generates them,\n"
+         "                      or substitution, which inflates a smaller drawing.\n"
+         "  --order NAME        How the vertices are ordered once located: located, the\n"
+         "                      default, or along a morton or hilbert curve.\n"
+         "  --stats             Print the hot-path statistics of each case, when the\n"
+         "                      library is built with the QUASITILER_STATS option.\n"
+         "  --repeat N          Run each case N times and keep the best times. Default: 3.\n"
+         "  --threads N         Threads used by generate() and locate_tiles(), 0 for all\n"
+         "                      cores. Default: 1.\n"
+         "  --dimensions A,B    Dimensions to benchmark. Default: 3,4,5,6,7,8.\n"
+         "  --sizes A,B         Half-widths of the tiling bounds. Default: 10,20,40.\n",
+         a_program);
+   }
+
+   template <class T>
+   static bool parse_list(const char* a_text, std::vector<T>& some_values)
+   {
+      some_values.clear();
+      for (const char* text = a_text; *text; )
+      {
+         char* end = nullptr;
+         const double value = std::strtod(text, &end);
+         if (end == text)
+            return false;
+         some_values.emplace_back(T(value));
+         text = (*end == ',') ? end + 1 : end;
+         if (*end && *end != ',')
+            return false;
+      }
+      return !some_values.empty();
+   }
+
+   static bool parse_options(int argc, char** argv, options_t& some_options)
+   {
+      for (int arg = 1; arg < argc; ++arg)
+      {
+         const bool has_value = (arg + 1 < argc);
+         if (std::strcmp(argv[arg], "--json") == 0)
+            some_options.json = true;
+         else if (std::strcmp(argv[arg], "--adaptive") == 0)
+            some_options.adaptive = true;
+         else if (std::strcmp(argv[arg], "--stats") == 0)
+            some_options.stats = true;
+         else if (std::strcmp(argv[arg], "--engine") == 0 && has_value)
+         {
+            const char* name = argv[++arg];
+            const auto found = std::find_if(std::begin(engine_names), std::end(engine_names), [name](const char* an_engine_name)
+            {
+               return std::strcmp(name, an_engine_name) == 0;
+            });
+            if (found == std::end(engine_names))
+               return false;
+            some_options.engine = engine_t(found - std::begin(engine_names));
+         }
+         else if (std::strcmp(argv[arg], "--order") == 0 && has_value)
+         {
+            const char* name = argv[++arg];
+            const auto found = std::find_if(std::begin(vertex_order_names), std::end(vertex_order_names), [name](const char* an_order_name)
+            {
+               return std::strcmp(name, an_order_name) == 0;
+            });
+            if (found == std::end(vertex_order_names))
+               return false;
+            some_options.vertex_order = drawing_t::vertex_order_t(found - std::begin(vertex_order_names));
+         }
+         else if (std::strcmp(argv[arg], "--repeat") == 0 && has_value)
+            some_options.repeat = std::atoi(argv[++arg]);
+         else if (std::strcmp(argv[arg], "--threads") == 0 && has_value)
+            some_options.thread_count = std::atoi(argv[++arg]);
+         else if (std::strcmp(argv[arg], "--dimensions") == 0 && has_value)
+         {
+            if (!parse_list(argv[++arg], some_options.dimensions))
+               return false;
+            for (int dim : some_options.dimensions)
+               if (dim < 3 || dim > tiling_t::MAX_DIM)
+                  return false;
+         }
+         else if (std::strcmp(argv[arg], "--sizes") == 0 && has_value)
+         {
+            if (!parse_list(argv[++arg], some_options.sizes))
+               return false;
+         }
+         else
+            return false;
+      }
+      return true;
+   }
+}
+
+int main(int argc, char** argv)
+{
+   using namespace dak::quasitiler_benchmark;
+
+   options_t options;
+   if (!parse_options(argc, argv, options))
+   {
+      print_usage(argv[0]);
+      return 2;
+   }
+
+   std::vector<result_t> results;
+   for (double size : options.sizes)
+   {
+      for (int dim : options.dimensions)
+      {
+         result_t result;
+         if (!run_case(options, dim, size, result))
+         {
+            std::fprintf(stderr, "Failed to generate the tiling of dimension %d and size %g.\n", dim, size);
+            return 1;
+         }
+         results.emplace_back(result);
+      }
+   }
+
+   if (options.json)
+      print_json(options, results);
+   else
+      print_text(results);
+
+   if (options.stats && !options.json)
+      print_stats(results);
+
+   return 0;
+}
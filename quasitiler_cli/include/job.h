@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef DAK_QUASITILER_CLI_JOB_H
+#define DAK_QUASITILER_CLI_JOB_H
+
+#include <dak/quasitiler/tiling.h>
+
+#include <string>
+#include <vector>
+
+
+namespace dak::quasitiler_cli
+{
+   using tiling_t = dak::quasitiler::tiling_t;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // A tiling to generate and the file where to write it.
+
+   struct job_t
+   {
+      int            dimensions_count = 5;
+      double         offsets[tiling_t::MAX_DIM] = { 0., 0., 0., 0., 0., 0., 0., 0., };
+      double         bounds[2][tiling_t::MAX_DIM] =
+      {
+         { -20., -20., -20., -20., -20., -20., -20., -20., },
+         {  20.,  20.,  20.,  20.,  20.,  20.,  20.,  20., },
+      };
+      int            thread_count = 1;
+      double         tile_size = 20.;
+      bool           antialias = true;
+      std::string    output;
+   };
+
+   // Parse the options of a job. Options not given keep their value.
+   // Returns false and fills the error if an option is invalid.
+   bool parse_job(const std::vector<std::string>& some_arguments, job_t& a_job, std::string& an_error);
+
+   // Parse a job file: one job per line, with the same options as on the
+   // command line. Empty lines and lines starting with # are ignored.
+   // The jobs start from the given defaults.
+   bool parse_job_file(const std::string& a_file_name, const job_t& some_defaults, std::vector<job_t>& some_jobs, std::string& an_error);
+
+   // Generate the tiling of a job, locate its tiles and write them.
+   // Returns false and fills the error if anything fails.
+   bool run_job(const job_t& a_job, std::string& an_error);
+
+   // Description of the job options, for the usage message.
+   const char* get_job_options_usage();
+}
+
+#endif /* DAK_QUASITILER_CLI_JOB_H */
@@ -0,0 +1,373 @@
+#include "job.h"
+
+#include <dak/quasitiler/chunked_drawing.h>
+#include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/interruptor.h>
+#include <dak/quasitiler/rasterizer.h>
+#include <dak/quasitiler/svg_writer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+
+namespace dak::quasitiler_cli
+{
+   using namespace dak::quasitiler;
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Job options parsing.
+
+   const char* get_job_options_usage()
+   {
+      return
+         "  --dimensions N         Dimension of the lattice, 3 to 8. Default: 5.\n"
+         "  --offsets A,B,...      Relative offsets of the tiling, one per dimension. Default: 0.\n"
+         "  --bounds X0,Y0,X1,Y1   Bounds of the tiling plane. Default: -20,-20,20,20.\n"
+         "  --threads N            Threads generating the tiling and locating its tiles,\n"
+         "                         0 for all cores. Default: 1.\n"
+         "  --tile-size N          Size of the tile edges in pictures, in pixels. Default: 20.\n"
+         "  --antialias 0|1        Antialias PNG pictures. Default: 1.\n"
+         "  --output FILE          File where to write the tiling. Required.\n";
+   }
+
+   namespace
+   {
+      // Parse a comma-separated list of numbers.
+      bool parse_numbers(const std::string& a_text, std::vector<double>& some_numbers)
+      {
+         some_numbers.clear();
+         const char* text = a_text.c_str();
+         while (*text)
+         {
+            char* end = nullptr;
+            some_numbers.emplace_back(std::strtod(text, &end));
+            if (end == text || (*end && *end != ','))
+               return false;
+            text = *end ? end + 1 : end;
+         }
+         return !some_numbers.empty();
+      }
+
+      bool parse_int(const std::string& a_text, int& a_value)
+      {
+         char* end = nullptr;
+         const long value = std::strtol(a_text.c_str(), &end, 10);
+         if (a_text.empty() || *end)
+            return false;
+         a_value = int(value);
+         return true;
+      }
+
+      // Split a job line in arguments, at spaces, except in double quotes.
+      std::vector<std::string> split_arguments(const std::string& a_line)
+      {
+         std::vector<std::string> arguments;
+         std::string argument;
+         bool in_argument = false;
+         bool in_quotes = false;
+         for (const char c : a_line)
+         {
+            if (c == '"')
+            {
+               in_quotes = !in_quotes;
+               in_argument = true;
+            }
+            else if (!in_quotes && (c == ' ' || c == '\t' || c == '\r'))
+            {
+               if (in_argument)
+                  arguments.emplace_back(std::move(argument));
+               argument.clear();
+               in_argument = false;
+            }
+            else
+            {
+               argument += c;
+               in_argument = true;
+            }
+         }
+         if (in_argument)
+            arguments.emplace_back(std::move(argument));
+         return arguments;
+      }
+   }
+
+   bool parse_job(const std::vector<std::string>& some_arguments, job_t& a_job, std::string& an_error)
+   {
+      for (size_t index = 0; index < some_arguments.size(); ++index)
+      {
+         const std::string& option = some_arguments[index];
+         if (index + 1 >= some_arguments.size())
+         {
+            an_error = "missing value for option " + option;
+            return false;
+         }
+         const std::string& value = some_arguments[++index];
+
+         std::vector<double> numbers;
+         if (option == "--dimensions")
+         {
+            if (!parse_int(value, a_job.dimensions_count) || a_job.dimensions_count < 3 || a_job.dimensions_count > tiling_t::MAX_DIM)
+            {
+               an_error = "invalid dimensions: " + value;
+               return false;
+            }
+         }
+         else if (option == "--offsets")
+         {
+            if (!parse_numbers(value, numbers) || numbers.size() > tiling_t::MAX_DIM)
+            {
+               an_error = "invalid offsets: " + value;
+               return false;
+            }
+            std::fill(a_job.offsets, a_job.offsets + tiling_t::MAX_DIM, 0.);
+            std::copy(numbers.begin(), numbers.end(), a_job.offsets);
+         }
+         else if (option == "--bounds")
+         {
+            if (!parse_numbers(value, numbers) || numbers.size() != 4 || numbers[0] >= numbers[2] || numbers[1] >= numbers[3])
+            {
+               an_error = "invalid bounds: " + value;
+               return false;
+            }
+            a_job.bounds[0][0] = numbers[0];
+            a_job.bounds[0][1] = numbers[1];
+            a_job.bounds[1][0] = numbers[2];
+            a_job.bounds[1][1] = numbers[3];
+         }
+         else if (option == "--threads")
+         {
+            if (!parse_int(value, a_job.thread_count))
+            {
+               an_error = "invalid thread count: " + value;
+               return false;
+            }
+         }
+         else if (option == "--tile-size")
+         {
+            if (!parse_numbers(value, numbers) || numbers.size() != 1 || numbers[0] <= 0.)
+            {
+               an_error = "invalid tile size: " + value;
+               return false;
+            }
+            a_job.tile_size = numbers[0];
+         }
+         else if (option == "--antialias")
+         {
+            int antialias = 0;
+            if (!parse_int(value, antialias) || antialias < 0 || antialias > 1)
+            {
+               an_error = "invalid antialias: " + value;
+               return false;
+            }
+            a_job.antialias = (antialias != 0);
+         }
+         else if (option == "--output")
+         {
+            a_job.output = value;
+         }
+         else
+         {
+            an_error = "unknown option " + option;
+            return false;
+         }
+      }
+
+      return true;
+   }
+
+   bool parse_job_file(const std::string& a_file_name, const job_t& some_defaults, std::vector<job_t>& some_jobs, std::string& an_error)
+   {
+      std::ifstream file(a_file_name);
+      if (!file)
+      {
+         an_error = "cannot read job file " + a_file_name;
+         return false;
+      }
+
+      int line_number = 0;
+      std::string line;
+      while (std::getline(file, line))
+      {
+         ++line_number;
+
+         const std::vector<std::string> arguments = split_arguments(line);
+         if (arguments.empty() || arguments[0][0] == '#')
+            continue;
+
+         job_t job = some_defaults;
+         if (!parse_job(arguments, job, an_error))
+         {
+            an_error = a_file_name + ":" + std::to_string(line_number) + ": " + an_error;
+            return false;
+         }
+         if (job.output.empty())
+         {
+            an_error = a_file_name + ":" + std::to_string(line_number) + ": missing --output";
+            return false;
+         }
+         some_jobs.emplace_back(job);
+      }
+
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   //
+   // Job execution.
+
+   namespace
+   {
+      struct never_interrupted_t : interruptor_t
+      {
+         bool interrupted() override { return false; }
+      };
+
+      // Write the tiling in a line-based text format:
+      //
+      //    quasitiler 1
+      //    dimensions N
+      //    offsets O0 ... ON
+      //    bounds X0 Y0 X1 Y1
+      //    generators N, then one line per dimension: X Y
+      //    vertices V, then one line per vertex: X Y C0 ... CN
+      //    tiles T, then one line per tile: GEN0 GEN1 VERTEX-INDEX
+      //
+      // The vertices are given both projected in the tiling plane and
+      // as lattice coordinates. A tile is the parallelogram formed by its
+      // vertex and the two generators.
+      bool write_drawing(const job_t& a_job, const drawing_t& a_drawing, std::string& an_error)
+      {
+         // The buffer must outlive the file, which is flushed when closed.
+         std::vector<char> buffer(1 << 20);
+         std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(a_job.output.c_str(), "w"), std::fclose);
+         if (!file)
+         {
+            an_error = "cannot write " + a_job.output;
+            return false;
+         }
+
+         std::FILE* out = file.get();
+         std::setvbuf(out, buffer.data(), _IOFBF, buffer.size());
+
+         const tiling_t& tiling = *a_drawing.get_tiling();
+         const int dim_count = tiling.dimensions_count();
+
+         std::fprintf(out, "quasitiler 1\n");
+         std::fprintf(out, "dimensions %d\n", dim_count);
+         std::fprintf(out, "offsets");
+         for (int ind = 0; ind < dim_count; ++ind)
+            std::fprintf(out, " %.17g", a_job.offsets[ind]);
+         std::fprintf(out, "\nbounds %.17g %.17g %.17g %.17g\n", a_job.bounds[0][0], a_job.bounds[0][1], a_job.bounds[1][0], a_job.bounds[1][1]);
+
+         std::fprintf(out, "generators %d\n", dim_count);
+         for (int ind = 0; ind < dim_count; ++ind)
+            std::fprintf(out, "%.17g %.17g\n", tiling.generator[0][ind], tiling.generator[1][ind]);
+
+         const drawing_t::vertex_list_t& vertices = a_drawing.get_vertex_storage();
+         std::fprintf(out, "vertices %zu\n", vertices.size());
+         for (const vertex_t vertex : vertices)
+         {
+            tiling_point_t point;
+            a_drawing.lattice_to_tiling(vertex, point);
+            std::fprintf(out, "%.9g %.9g", point.x, point.y);
+            for (int ind = 0; ind < dim_count; ++ind)
+               std::fprintf(out, " %d", vertex.coords[ind]);
+            std::fputc('\n', out);
+         }
+
+         size_t tile_count = 0;
+         for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+            tile_count += a_drawing.get_tile_storage()[comb].size();
+
+         std::fprintf(out, "tiles %zu\n", tile_count);
+         for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+            for (const size_t vertex_index : a_drawing.get_tile_storage()[comb])
+               std::fprintf(out, "%d %d %zu\n", tiling.tile_generator[comb][0], tiling.tile_generator[comb][1], vertex_index);
+
+         if (std::fflush(out) != 0 || std::ferror(out))
+         {
+            an_error = "cannot write " + a_job.output;
+            return false;
+         }
+
+         return true;
+      }
+   }
+
+   bool run_job(const job_t& a_job, std::string& an_error)
+   {
+      job_t job = a_job;
+
+      auto tiling = std::make_shared<tiling_t>(job.dimensions_count);
+      if (!tiling->init(job.offsets))
+      {
+         an_error = "invalid tiling parameters";
+         return false;
+      }
+
+      never_interrupted_t never;
+
+      // Pictures are written chunk by chunk, as the tiles are located.
+      if (std::filesystem::path(job.output).extension() == ".svg")
+      {
+         svg_style_t style;
+         style.tile_size = job.tile_size;
+         svg_writer_t writer(tiling, style);
+         if (!writer.open(job.output, job.bounds))
+         {
+            an_error = "cannot write " + job.output;
+            return false;
+         }
+
+         chunked_drawing_t chunked(tiling);
+         chunked.set_thread_count(job.thread_count);
+         if (!chunked.generate(job.bounds, writer, never))
+         {
+            an_error = "cannot generate the tiling";
+            return false;
+         }
+
+         if (!writer.close())
+         {
+            an_error = "cannot write " + job.output;
+            return false;
+         }
+
+         return true;
+      }
+
+      drawing_t drawing(tiling);
+      if (!tiling->generate(job.bounds, drawing, never, job.thread_count))
+      {
+         an_error = "cannot generate the tiling";
+         return false;
+      }
+
+      if (!drawing.locate_tiles(never, job.thread_count))
+      {
+         an_error = "cannot locate the tiles";
+         return false;
+      }
+
+      // Pictures are drawn in bands, from the located tiles.
+      if (std::filesystem::path(job.output).extension() == ".png")
+      {
+         raster_style_t style;
+         style.tile_size = job.tile_size;
+         style.antialias = job.antialias;
+         if (!write_png_file(job.output, drawing, job.bounds, style, job.thread_count))
+         {
+            an_error = "cannot write " + job.output;
+            return false;
+         }
+         return true;
+      }
+
+      return write_drawing(job, drawing, an_error);
+   }
+}
@@ -0,0 +1,155 @@
+#include "job.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace dak::quasitiler_cli
+{
+   static void print_usage(const char* a_program)
+   {
+      std::fprintf(stderr,
+         "Usage: %s [job options]\n"
+         "       %s --jobs FILE [--workers N] [job options]\n"
+         "\n"
+         "Generate quasi-periodic tilings and write their vertices and tiles.\n"
+         "\n"
+         "With a job file, each non-empty line not starting with # is a job given\n"
+         "with the job options. The job options on the command line are the defaults\n"
+         "of all jobs. The jobs are run concurrently.\n"
+         "\n"
+         "Options:\n"
+         "  --jobs FILE            File containing the jobs to run.\n"
+         "  --workers N            Jobs run at the same time. Default: all cores.\n"
+         "\n"
+         "Job options:\n"
+         "%s"
+         "\n"
+         "Output, in text, one item per line:\n"
+         "  quasitiler 1, then the dimensions, offsets and bounds lines.\n"
+         "  generators N, then each generator projected in the plane: X Y\n"
+         "  vertices V, then each vertex projected and in the lattice: X Y C0 ... CN\n"
+         "  tiles T, then each tile as its two generators and vertex index: G0 G1 V\n"
+         "\n"
+         "An output file ending in .svg is written as an SVG picture of the tiles\n"
+         "instead. The tiling is then generated in chunks, so that its size is not\n"
+         "limited by the memory. An output file ending in .png is written as a PNG\n"
+         "picture, drawn in bands by the generating threads.\n",
+         a_program, a_program, get_job_options_usage());
+   }
+
+   // Run the jobs, each worker thread taking the next job when done with
+   // its current one. Returns the number of failed jobs.
+   static int run_jobs(const std::vector<job_t>& some_jobs, int a_worker_count)
+   {
+      std::atomic<size_t> next_job = 0;
+      std::atomic<int> failed_count = 0;
+      std::mutex output_mutex;
+
+      auto work = [&]()
+      {
+         for (size_t index = next_job++; index < some_jobs.size(); index = next_job++)
+         {
+            const job_t& job = some_jobs[index];
+
+            std::string error;
+            bool is_done = false;
+            try
+            {
+               is_done = run_job(job, error);
+            }
+            catch (const std::exception& ex)
+            {
+               error = ex.what();
+            }
+
+            if (!is_done)
+               ++failed_count;
+
+            std::lock_guard lock(output_mutex);
+            if (is_done)
+               std::fprintf(stderr, "done: %s\n", job.output.c_str());
+            else
+               std::fprintf(stderr, "failed: %s: %s\n", job.output.c_str(), error.c_str());
+         }
+      };
+
+      if (a_worker_count <= 0)
+         a_worker_count = std::max(1, (int)std::thread::hardware_concurrency());
+      a_worker_count = std::max(1, std::min(a_worker_count, (int)some_jobs.size()));
+
+      std::vector<std::thread> workers;
+      for (int worker = 1; worker < a_worker_count; ++worker)
+         workers.emplace_back(work);
+      work();
+      for (std::thread& worker : workers)
+         worker.join();
+
+      return failed_count;
+   }
+}
+
+int main(int argc, char** argv)
+{
+   using namespace dak::quasitiler_cli;
+
+   // Separate the batch options from the job options.
+
+   std::string jobs_file_name;
+   int worker_count = 0;
+   std::vector<std::string> job_arguments;
+   for (int arg = 1; arg < argc; ++arg)
+   {
+      if (std::strcmp(argv[arg], "--help") == 0)
+      {
+         print_usage(argv[0]);
+         return 0;
+      }
+      else if (std::strcmp(argv[arg], "--jobs") == 0 && arg + 1 < argc)
+      {
+         jobs_file_name = argv[++arg];
+      }
+      else if (std::strcmp(argv[arg], "--workers") == 0 && arg + 1 < argc)
+      {
+         worker_count = std::atoi(argv[++arg]);
+      }
+      else
+      {
+         job_arguments.emplace_back(argv[arg]);
+      }
+   }
+
+   std::string error;
+   job_t defaults;
+   if (!parse_job(job_arguments, defaults, error))
+   {
+      std::fprintf(stderr, "%s\n\n", error.c_str());
+      print_usage(argv[0]);
+      return 2;
+   }
+
+   std::vector<job_t> jobs;
+   if (jobs_file_name.empty())
+   {
+      if (defaults.output.empty())
+      {
+         std::fprintf(stderr, "missing --output\n\n");
+         print_usage(argv[0]);
+         return 2;
+      }
+      jobs.emplace_back(defaults);
+   }
+   else if (!parse_job_file(jobs_file_name, defaults, jobs, error))
+   {
+      std::fprintf(stderr, "%s\n", error.c_str());
+      return 2;
+   }
+
+   return run_jobs(jobs, worker_count) == 0 ? 0 : 1;
+}
@@ -4,9 +4,58 @@
 #define DAK_TANTRIX_TESTS_HELPERS_H
 
 #include <dak/quasitiler/tiling_point.h>
+#include <dak/quasitiler/point_reporter.h>
+#include <dak/quasitiler/interruptor.h>
+#include <dak/quasitiler/chunked_drawing.h>
 
 #include "CppUnitTest.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace dak::quasitiler::tests
+{
+	// Interruptor that never interrupts.
+	struct never_interrupted_t : interruptor_t
+	{
+		bool interrupted() override { return false; }
+	};
+
+	// Reporter that keeps all points in the order they were reported.
+	struct points_t : point_reporter_t
+	{
+		std::vector<vertex_t> points;
+
+		void report_point(const vertex_t& a_point) override { points.emplace_back(a_point); }
+	};
+
+	using tiles_t = std::vector<std::pair<int, vertex_t>>;
+
+	// The tiles of a drawing whose center is within the given bounds, sorted.
+	inline tiles_t tiles_within(const drawing_t& a_drawing, const double some_bounds[2][tiling_t::MAX_DIM])
+	{
+		chunked_drawing_t centers(a_drawing.get_tiling());
+
+		tiles_t tiles;
+		for (int comb = 0; comb < a_drawing.get_tiling()->tile_combinations_count(); ++comb)
+		{
+			for (size_t tile : a_drawing.my_tile_storage[comb])
+			{
+				const vertex_t vertex = a_drawing.my_vertex_storage[tile];
+				const tiling_point_t center = centers.get_tile_center(comb, vertex);
+				if (center.x < some_bounds[0][0] || center.x > some_bounds[1][0])
+					continue;
+				if (center.y < some_bounds[0][1] || center.y > some_bounds[1][1])
+					continue;
+				tiles.emplace_back(comb, vertex);
+			}
+		}
+		std::sort(tiles.begin(), tiles.end());
+		return tiles;
+	}
+}
+
 namespace Microsoft::VisualStudio::CppUnitTestFramework
 {
 	//template<>
@@ -0,0 +1,69 @@
+#include <dak/quasitiler/chunked_drawing.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	// Reporter that keeps the owned tiles of all chunks.
+	struct chunk_tiles_t : chunk_reporter_t
+	{
+		std::vector<std::pair<int, vertex_t>> tiles;
+		int chunks_count = 0;
+
+		void report_chunk(const drawing_t& a_chunk) override
+		{
+			++chunks_count;
+			for (int comb = 0; comb < a_chunk.get_tiling()->tile_combinations_count(); ++comb)
+				for (size_t tile : a_chunk.my_tile_storage[comb])
+					tiles.emplace_back(comb, a_chunk.my_vertex_storage[tile]);
+		}
+	};
+
+	TEST_CLASS(chunked_drawing_tests)
+	{
+	public:
+
+		TEST_METHOD(small_chunks_match_one_chunk)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -12., -9., -10., -10., -10., -10., -10., -10., },
+				{  11.,  13.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				never_interrupted_t never;
+				chunked_drawing_t whole(tiling);
+				chunked_drawing_t chunked(tiling);
+				whole.set_chunk_size(0.);
+				chunked.set_chunk_size(4.5);
+
+				chunk_tiles_t whole_tiles;
+				chunk_tiles_t chunked_tiles;
+				Assert::IsTrue(whole.generate(bounds, whole_tiles, never));
+				Assert::IsTrue(chunked.generate(bounds, chunked_tiles, never));
+
+				Assert::AreEqual(1, whole_tiles.chunks_count);
+				Assert::IsTrue(chunked_tiles.chunks_count > 1);
+
+				std::sort(whole_tiles.tiles.begin(), whole_tiles.tiles.end());
+				std::sort(chunked_tiles.tiles.begin(), chunked_tiles.tiles.end());
+				Assert::IsTrue(std::adjacent_find(chunked_tiles.tiles.begin(), chunked_tiles.tiles.end()) == chunked_tiles.tiles.end());
+				Assert::IsTrue(whole_tiles.tiles == chunked_tiles.tiles);
+			}
+		}
+	};
+}
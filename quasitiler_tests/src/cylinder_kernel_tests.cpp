@@ -0,0 +1,78 @@
+#include <dak/quasitiler/cylinder_kernel.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(cylinder_kernel_tests)
+	{
+	public:
+
+		TEST_METHOD(all_kernels_agree)
+		{
+			std::mt19937 random(7);
+			std::uniform_real_distribution<double> coefficient(-1., 1.);
+			std::uniform_int_distribution<int> coordinate(-3, 3);
+
+			for (int dim = 3; dim <= cylinder_columns_t::MAX_DIM; ++dim)
+			{
+				// The generic kernels and the ones specialized for the dimension.
+				std::vector<const cylinder_kernel_t*> kernels;
+				for (int kernel_dim : { 0, dim })
+				{
+					kernels.emplace_back(&get_scalar_cylinder_kernel(kernel_dim));
+					if (auto kernel = get_sse2_cylinder_kernel(kernel_dim))
+						kernels.emplace_back(kernel);
+					if (auto kernel = get_avx2_cylinder_kernel(kernel_dim))
+						kernels.emplace_back(kernel);
+				}
+
+				cylinder_columns_t columns;
+				columns.dimensions_count = dim;
+				columns.criteria_count = dim * (dim - 1) * (dim - 2) / 6;
+				columns.padded_criteria_count = (columns.criteria_count + cylinder_columns_t::CRITERIA_ALIGN - 1)
+				                              / cylinder_columns_t::CRITERIA_ALIGN * cylinder_columns_t::CRITERIA_ALIGN;
+				for (int crit = 0; crit < columns.criteria_count; ++crit)
+					for (int ind = 0; ind < dim; ++ind)
+						columns.columns[ind][crit] = coefficient(random) / dim;
+
+				for (int point_index = 0; point_index < 10000; ++point_index)
+				{
+					double point[cylinder_columns_t::MAX_DIM] = { };
+					for (int ind = 0; ind < dim; ++ind)
+						point[ind] = coordinate(random) + coefficient(random) * 0.5;
+
+					double expected[cylinder_columns_t::MAX_PADDED_CRITERIA];
+					kernels[0]->evaluate(columns, point, expected);
+					const bool expected_inside = kernels[0]->contains(columns, point, 0.000001);
+					const auto expected_position = kernels[0]->classify(columns, expected, 0.9, 1.1);
+
+					for (const cylinder_kernel_t* kernel : kernels)
+					{
+						double values[cylinder_columns_t::MAX_PADDED_CRITERIA];
+						kernel->evaluate(columns, point, values);
+						for (int crit = 0; crit < columns.criteria_count; ++crit)
+							Assert::IsTrue(values[crit] == expected[crit]);
+
+						Assert::AreEqual(expected_inside, kernel->contains(columns, point, 0.000001));
+						Assert::IsTrue(expected_position == kernel->classify(columns, values, 0.9, 1.1));
+
+						kernel->move(columns, dim - 1, -2., values);
+						kernels[0]->move(columns, dim - 1, -2., expected);
+						for (int crit = 0; crit < columns.criteria_count; ++crit)
+							Assert::IsTrue(values[crit] == expected[crit]);
+						kernels[0]->move(columns, dim - 1, 2., expected);
+						kernels[0]->evaluate(columns, point, expected);
+					}
+				}
+			}
+		}
+	};
+}
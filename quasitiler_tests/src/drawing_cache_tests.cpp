@@ -0,0 +1,102 @@
+#include <dak/quasitiler/drawing_cache.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <filesystem>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(drawing_cache_tests)
+	{
+	public:
+
+		static std::shared_ptr<tiling_t> make_tiling(int dim, double an_offset)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., an_offset, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			auto tiling = std::make_shared<tiling_t>(dim);
+			Assert::IsTrue(tiling->init(offsets));
+			return tiling;
+		}
+
+		static std::shared_ptr<drawing_t> make_drawing(const std::shared_ptr<tiling_t>& a_tiling, double bounds[2][tiling_t::MAX_DIM])
+		{
+			never_interrupted_t never;
+			auto drawing = std::make_shared<drawing_t>(a_tiling);
+			Assert::IsTrue(a_tiling->generate(bounds, *drawing, never));
+			Assert::IsTrue(drawing->locate_tiles(never));
+			return drawing;
+		}
+
+		TEST_METHOD(keys_follow_parameters)
+		{
+			double bounds[2][tiling_t::MAX_DIM] = { { -5., -5., }, { 5., 5., } };
+			double other_bounds[2][tiling_t::MAX_DIM] = { { -5., -5., 1., }, { 5., 6., } };
+
+			const drawing_key_t key(*make_tiling(5, 0.1), bounds);
+			Assert::IsTrue(key == drawing_key_t(*make_tiling(5, 0.1), bounds));
+			Assert::IsFalse(key == drawing_key_t(*make_tiling(5, 0.11), bounds));
+			Assert::IsFalse(key == drawing_key_t(*make_tiling(6, 0.1), bounds));
+			Assert::IsFalse(key == drawing_key_t(*make_tiling(5, 0.1), other_bounds));
+			Assert::AreNotEqual(key.hash, drawing_key_t(*make_tiling(5, 0.11), bounds).hash);
+		}
+
+		TEST_METHOD(memory_tier_keeps_most_recent)
+		{
+			double bounds[2][tiling_t::MAX_DIM] = { { -5., -5., }, { 5., 5., } };
+
+			drawing_cache_t cache(2);
+			std::shared_ptr<tiling_t> tilings[3];
+			drawing_key_t keys[3];
+			for (int index = 0; index < 3; ++index)
+			{
+				tilings[index] = make_tiling(5, 0.1 * index);
+				keys[index] = drawing_key_t(*tilings[index], bounds);
+				cache.insert(keys[index], make_drawing(tilings[index], bounds));
+
+				// Use the first one so it stays in the cache.
+				Assert::IsNotNull(cache.find(keys[0], tilings[0]).get());
+			}
+
+			Assert::IsNotNull(cache.find(keys[0], tilings[0]).get());
+			Assert::IsNull(cache.find(keys[1], tilings[1]).get());
+			Assert::IsNotNull(cache.find(keys[2], tilings[2]).get());
+		}
+
+		TEST_METHOD(disk_tier_restores_drawing)
+		{
+			double bounds[2][tiling_t::MAX_DIM] = { { -8., -6., }, { 7., 8., } };
+			const auto directory = std::filesystem::temp_directory_path() / "quasitiler_drawing_cache_tests";
+			std::filesystem::remove_all(directory);
+
+			auto tiling = make_tiling(7, 0.1);
+			auto drawing = make_drawing(tiling, bounds);
+			const drawing_key_t key(*tiling, bounds);
+
+			{
+				drawing_cache_t cache;
+				cache.set_disk_directory(directory);
+				cache.insert(key, drawing);
+			}
+
+			drawing_cache_t cache;
+			cache.set_disk_directory(directory);
+			auto other_tiling = make_tiling(7, 0.1);
+			Assert::IsNull(cache.find(drawing_key_t(*make_tiling(7, 0.2), bounds), make_tiling(7, 0.2)).get());
+			auto loaded = cache.find(key, other_tiling);
+			Assert::IsNotNull(loaded.get());
+			Assert::IsTrue(other_tiling->is_generated());
+
+			Assert::AreEqual(drawing->my_vertex_storage.size(), loaded->my_vertex_storage.size());
+			for (size_t index = 0; index < drawing->my_vertex_storage.size(); ++index)
+				Assert::IsTrue(drawing->my_vertex_storage[index] == loaded->my_vertex_storage[index]);
+			for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+				Assert::IsTrue(drawing->my_tile_storage[comb] == loaded->my_tile_storage[comb]);
+
+			std::filesystem::remove_all(directory);
+		}
+	};
+}
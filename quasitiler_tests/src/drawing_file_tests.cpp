@@ -0,0 +1,145 @@
+#include <dak/quasitiler/drawing_file.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(drawing_file_tests)
+	{
+	public:
+
+		static std::shared_ptr<drawing_t> make_drawing(int dim)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] = { { -6., -5., }, { 5., 6., } };
+
+			never_interrupted_t never;
+			auto tiling = std::make_shared<tiling_t>(dim);
+			Assert::IsTrue(tiling->init(offsets));
+			auto drawing = std::make_shared<drawing_t>(tiling);
+			Assert::IsTrue(tiling->generate(bounds, *drawing, never));
+			Assert::IsTrue(drawing->locate_tiles(never));
+			return drawing;
+		}
+
+		static void verify_mapped(const drawing_t& a_drawing, const mapped_drawing_t& a_mapped)
+		{
+			const tiling_t& tiling = *a_drawing.get_tiling();
+			Assert::IsTrue(a_mapped.is_open());
+			Assert::AreEqual(tiling.dimensions_count(), a_mapped.dimensions_count());
+			Assert::AreEqual(tiling.tile_combinations_count(), a_mapped.tile_combinations_count());
+			for (int ind = 0; ind < tiling.dimensions_count(); ++ind)
+			{
+				Assert::AreEqual(tiling.generator[0][ind], a_mapped.get_header().generator[0][ind]);
+				Assert::AreEqual(tiling.offset[ind], a_mapped.get_header().offset[ind]);
+			}
+
+			const packed_vertex_view_t vertices = a_mapped.get_vertex_storage();
+			Assert::AreEqual(a_drawing.my_vertex_storage.is_packed(), vertices.is_packed());
+			Assert::AreEqual(a_drawing.my_vertex_storage.size(), vertices.size());
+			for (size_t index = 0; index < vertices.size(); ++index)
+				Assert::IsTrue(a_drawing.my_vertex_storage[index] == vertices[index]);
+
+			for (int comb = 0; comb < tiling.tile_combinations_count(); ++comb)
+			{
+				const auto tiles = a_mapped.get_tile_storage(comb);
+				Assert::AreEqual(a_drawing.my_tile_storage[comb].size(), tiles.size());
+				for (size_t index = 0; index < tiles.size(); ++index)
+					Assert::AreEqual(std::uint64_t(a_drawing.my_tile_storage[comb][index]), tiles[index]);
+			}
+		}
+
+		TEST_METHOD(packed_drawing_round_trip)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_packed_drawing.qtiling";
+
+			auto drawing = make_drawing(5);
+			Assert::IsTrue(drawing->my_vertex_storage.is_packed());
+			Assert::IsTrue(write_drawing_file(file_name, *drawing));
+
+			mapped_drawing_t mapped;
+			Assert::IsTrue(mapped.open(file_name));
+			verify_mapped(*drawing, mapped);
+
+			mapped.close();
+			Assert::IsFalse(mapped.is_open());
+			std::filesystem::remove(file_name);
+		}
+
+		TEST_METHOD(full_drawing_round_trip)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_full_drawing.qtiling";
+
+			// Copy the vertices with a packing too small for them.
+			auto packed = make_drawing(7);
+			drawing_t drawing(packed->get_tiling());
+			int bounds[2][vertex_t::MAX_DIM] = { };
+			drawing.my_vertex_storage.set_packing(vertex_packing_t(bounds, 7));
+			for (const vertex_t vertex : packed->my_vertex_storage)
+				drawing.my_vertex_storage.push_back(vertex);
+			for (int comb = 0; comb < packed->get_tiling()->tile_combinations_count(); ++comb)
+				drawing.my_tile_storage[comb] = packed->my_tile_storage[comb];
+			Assert::IsFalse(drawing.my_vertex_storage.is_packed());
+
+			Assert::IsTrue(write_drawing_file(file_name, drawing));
+
+			mapped_drawing_t mapped;
+			Assert::IsTrue(mapped.open(file_name));
+			verify_mapped(drawing, mapped);
+
+			mapped.close();
+			std::filesystem::remove(file_name);
+		}
+
+		TEST_METHOD(invalid_files_are_refused)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_invalid_drawing.qtiling";
+
+			mapped_drawing_t mapped;
+			std::filesystem::remove(file_name);
+			Assert::IsFalse(mapped.open(file_name));
+
+			Assert::IsTrue(write_drawing_file(file_name, *make_drawing(4)));
+			const auto size = std::filesystem::file_size(file_name);
+
+			// A truncated file.
+			std::filesystem::resize_file(file_name, size - 8);
+			Assert::IsFalse(mapped.open(file_name));
+
+			// A corrupted dimension count.
+			Assert::IsTrue(write_drawing_file(file_name, *make_drawing(4)));
+			{
+				std::fstream stream(file_name, std::ios::binary | std::ios::in | std::ios::out);
+				const std::int32_t dim_count = 12;
+				stream.seekp(offsetof(drawing_file_header_t, dimensions_count));
+				stream.write(reinterpret_cast<const char*>(&dim_count), sizeof(dim_count));
+			}
+			Assert::IsFalse(mapped.open(file_name));
+			Assert::IsFalse(mapped.is_open());
+
+			// Corrupted packing bounds, too wide to fit in a key.
+			Assert::IsTrue(write_drawing_file(file_name, *make_drawing(4)));
+			{
+				std::fstream stream(file_name, std::ios::binary | std::ios::in | std::ios::out);
+				std::int32_t packing_bounds[2][drawing_file_header_t::MAX_DIM];
+				for (int ind = 0; ind < drawing_file_header_t::MAX_DIM; ++ind)
+				{
+					packing_bounds[0][ind] = -2000000000;
+					packing_bounds[1][ind] = 2000000000;
+				}
+				stream.seekp(offsetof(drawing_file_header_t, packing_bounds));
+				stream.write(reinterpret_cast<const char*>(packing_bounds), sizeof(packing_bounds));
+			}
+			Assert::IsFalse(mapped.open(file_name));
+
+			std::filesystem::remove(file_name);
+		}
+	};
+}
@@ -1,8 +1,13 @@
 #include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler/vertex_index.h>
 #include <dak/quasitiler_tests/helpers.h>
 
 #include "CppUnitTest.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace dak::quasitiler;
 
@@ -16,5 +21,241 @@ namespace dak::quasitiler::tests
 		{
          // TODO: drawing tests
 		}
+
+		TEST_METHOD(hashed_and_sorted_tiles_match)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -10., -10., -10., -10., -10., -10., -10., -10., },
+				{  10.,  10.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				never_interrupted_t never;
+				drawing_t sorted(tiling);
+				drawing_t hashed(tiling);
+				sorted.set_tile_search(drawing_t::tile_search_t::sorted);
+				hashed.set_tile_search(drawing_t::tile_search_t::hashed);
+				Assert::IsTrue(tiling->generate(bounds, sorted, never));
+				Assert::IsTrue(tiling->generate(bounds, hashed, never));
+				Assert::IsTrue(sorted.locate_tiles(never));
+				Assert::IsTrue(hashed.locate_tiles(never));
+
+				for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+				{
+					Assert::AreEqual(sorted.my_tile_storage[comb].size(), hashed.my_tile_storage[comb].size());
+					for (size_t tile : hashed.my_tile_storage[comb])
+					{
+						const vertex_t& vertex = hashed.my_vertex_storage[tile];
+						const bool found = std::any_of(sorted.my_tile_storage[comb].begin(), sorted.my_tile_storage[comb].end(), [&](size_t other)
+						{
+							return sorted.my_vertex_storage[other] == vertex;
+						});
+						Assert::IsTrue(found);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(parallel_locate_matches_serial)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -60., -60., -60., -60., -60., -60., -60., -60., },
+				{  60.,  60.,  60.,  60.,  60.,  60.,  60.,  60., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				for (auto search : { drawing_t::tile_search_t::sorted, drawing_t::tile_search_t::hashed })
+				{
+					never_interrupted_t never;
+					drawing_t serial(tiling);
+					serial.set_tile_search(search);
+					Assert::IsTrue(tiling->generate(bounds, serial, never));
+					Assert::IsTrue(serial.locate_tiles(never));
+
+					for (int thread_count : { 2, 3, 8 })
+					{
+						drawing_t parallel(tiling);
+						parallel.set_tile_search(search);
+						Assert::IsTrue(tiling->generate(bounds, parallel, never));
+						Assert::IsTrue(parallel.locate_tiles(never, thread_count));
+
+						Assert::AreEqual(serial.my_vertex_storage.size(), parallel.my_vertex_storage.size());
+						for (size_t index = 0; index < serial.my_vertex_storage.size(); ++index)
+							Assert::IsTrue(serial.my_vertex_storage[index] == parallel.my_vertex_storage[index]);
+						for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+							Assert::IsTrue(serial.my_tile_storage[comb] == parallel.my_tile_storage[comb]);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(parallel_index_keeps_first_vertex)
+		{
+			// Enough keys to be split between threads, some of them repeated.
+			std::vector<uint64_t> keys;
+			uint64_t key = 12345;
+			for (size_t index = 0; index < 300000; ++index)
+			{
+				key = key * 6364136223846793005ull + 1442695040888963407ull;
+				keys.emplace_back(index % 7 == 6 ? keys[index / 2] : key >> 16);
+			}
+
+			const vertex_index_t serial(keys, 1);
+			for (int thread_count : { 2, 4 })
+			{
+				const vertex_index_t parallel(keys, thread_count);
+				for (size_t index = 0; index < keys.size(); ++index)
+				{
+					const size_t first = serial.find(keys[index]);
+					Assert::IsTrue(first <= index && keys[first] == keys[index]);
+					Assert::AreEqual(first, parallel.find(keys[index]));
+				}
+				Assert::IsFalse(parallel.contains(uint64_t(-1)));
+			}
+		}
+
+		TEST_METHOD(tiling_points_match_vertices)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -60., -60., -60., -60., -60., -60., -60., -60., },
+				{  60.,  60.,  60.,  60.,  60.,  60.,  60.,  60., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				for (auto order : { drawing_t::vertex_order_t::located, drawing_t::vertex_order_t::hilbert })
+				{
+					never_interrupted_t never;
+					drawing_t drawing(tiling);
+					drawing.set_vertex_order(order);
+					Assert::IsTrue(tiling->generate(bounds, drawing, never));
+					Assert::IsTrue(drawing.locate_tiles(never, 3));
+
+					// The projected points follow the vertices, reordered or not.
+
+					const projected_points_t& points = drawing.get_tiling_points();
+					const size_t vertex_count = drawing.my_vertex_storage.size();
+					Assert::AreEqual(vertex_count, points.size());
+
+					std::vector<vertex_t> vertices;
+					for (size_t index = 0; index < vertex_count; ++index)
+					{
+						vertices.emplace_back(drawing.my_vertex_storage[index]);
+
+						tiling_point_t point;
+						drawing.lattice_to_tiling(vertices.back(), point);
+						Assert::IsTrue(point.x == points.xs[index]);
+						Assert::IsTrue(point.y == points.ys[index]);
+					}
+
+					// The batch conversions give the same points as the single ones.
+
+					for (int thread_count : { 1, 4 })
+					{
+						std::vector<double> xs(vertex_count);
+						std::vector<double> ys(vertex_count);
+						drawing.lattice_to_orthogonal(vertices, xs.data(), ys.data(), thread_count);
+						for (size_t index = 0; index < vertex_count; ++index)
+						{
+							tiling_point_t point;
+							drawing.lattice_to_orthogonal(vertices[index], point);
+							Assert::IsTrue(point.x == xs[index]);
+							Assert::IsTrue(point.y == ys[index]);
+						}
+
+						drawing.lattice_to_tiling(vertices, xs.data(), ys.data(), thread_count);
+						Assert::IsTrue(xs == points.xs);
+						Assert::IsTrue(ys == points.ys);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(vertex_order_keeps_tiles)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -20., -20., -20., -20., -20., -20., -20., -20., },
+				{  20.,  20.,  20.,  20.,  20.,  20.,  20.,  20., },
+			};
+			const double everywhere[2][tiling_t::MAX_DIM] =
+			{
+				{ -1e9, -1e9, },
+				{  1e9,  1e9, },
+			};
+
+			// Sum of the distances in the tiling plane between consecutive vertices.
+			auto path_length = [](const drawing_t& a_drawing)
+			{
+				double length = 0.;
+				tiling_point_t previous;
+				for (size_t index = 0; index < a_drawing.my_vertex_storage.size(); ++index)
+				{
+					tiling_point_t point;
+					a_drawing.lattice_to_tiling(a_drawing.my_vertex_storage[index], point);
+					if (index > 0)
+						length += std::hypot(point.x - previous.x, point.y - previous.y);
+					previous = point;
+				}
+				return length;
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				for (auto search : { drawing_t::tile_search_t::sorted, drawing_t::tile_search_t::hashed })
+				{
+					never_interrupted_t never;
+					drawing_t located(tiling);
+					located.set_tile_search(search);
+					Assert::IsTrue(tiling->generate(bounds, located, never));
+					Assert::IsTrue(located.locate_tiles(never));
+
+					std::vector<vertex_t> located_vertices(located.my_vertex_storage.begin(), located.my_vertex_storage.end());
+					std::sort(located_vertices.begin(), located_vertices.end());
+
+					for (auto order : { drawing_t::vertex_order_t::morton, drawing_t::vertex_order_t::hilbert })
+					{
+						drawing_t ordered(tiling);
+						ordered.set_tile_search(search);
+						ordered.set_vertex_order(order);
+						Assert::IsTrue(tiling->generate(bounds, ordered, never));
+						Assert::IsTrue(ordered.locate_tiles(never, 2));
+
+						std::vector<vertex_t> ordered_vertices(ordered.my_vertex_storage.begin(), ordered.my_vertex_storage.end());
+						std::sort(ordered_vertices.begin(), ordered_vertices.end());
+						Assert::IsTrue(located_vertices == ordered_vertices);
+						Assert::IsTrue(tiles_within(located, everywhere) == tiles_within(ordered, everywhere));
+
+						// The tiles follow their vertex. Along the Hilbert curve, which
+						// has no jump, consecutive vertices are closer.
+						for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+							Assert::IsTrue(std::is_sorted(ordered.my_tile_storage[comb].begin(), ordered.my_tile_storage[comb].end()));
+						if (order == drawing_t::vertex_order_t::hilbert)
+							Assert::IsTrue(path_length(ordered) < path_length(located));
+					}
+				}
+			}
+		}
 	};
 }
@@ -0,0 +1,97 @@
+#include <dak/quasitiler/multigrid_drawing.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(multigrid_drawing_tests)
+	{
+	public:
+
+		TEST_METHOD(multigrid_matches_scan)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -12., -9., -10., -10., -10., -10., -10., -10., },
+				{  11.,  13.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				never_interrupted_t never;
+				drawing_t scanned(tiling);
+				Assert::IsTrue(tiling->generate(bounds, scanned, never));
+				Assert::IsTrue(scanned.locate_tiles(never));
+
+				multigrid_drawing_t multigrid(tiling);
+				drawing_t intersected(tiling);
+				Assert::IsTrue(multigrid.generate(bounds, intersected, never));
+				Assert::IsFalse(multigrid.used_fallback());
+				Assert::IsTrue(tiling->is_generated());
+
+				// The scan only finds the tiles of the vertices it generated,
+				// so compare the tiles well inside the bounds.
+				const double inner[2][tiling_t::MAX_DIM] =
+				{
+					{ -8., -5., },
+					{  7.,  9., },
+				};
+				const tiles_t scanned_tiles = tiles_within(scanned, inner);
+				Assert::IsFalse(scanned_tiles.empty());
+				Assert::IsTrue(scanned_tiles == tiles_within(intersected, inner));
+
+				// The tiles are all distinct.
+				const double everywhere[2][tiling_t::MAX_DIM] =
+				{
+					{ -100., -100., },
+					{  100.,  100., },
+				};
+				const tiles_t all_tiles = tiles_within(intersected, everywhere);
+				Assert::IsTrue(std::adjacent_find(all_tiles.begin(), all_tiles.end()) == all_tiles.end());
+			}
+		}
+
+		TEST_METHOD(singular_tiling_falls_back_to_scan)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0. };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -5., -5., },
+				{  5.,  5., },
+			};
+
+			auto tiling = std::make_shared<tiling_t>(5);
+			Assert::IsTrue(tiling->init(offsets));
+
+			// Offset the plane so that it goes through the lattice point with
+			// the first three coordinates at one half, so three grid lines meet there.
+			for (int ind = tiling_t::TARGET_DIM; ind < 5; ++ind)
+				offsets[ind] = 0.5 * (tiling->generator[ind][0] + tiling->generator[ind][1] + tiling->generator[ind][2]);
+			Assert::IsTrue(tiling->init(offsets));
+
+			never_interrupted_t never;
+			drawing_t scanned(tiling);
+			Assert::IsTrue(tiling->generate(bounds, scanned, never));
+			Assert::IsTrue(scanned.locate_tiles(never));
+
+			multigrid_drawing_t multigrid(tiling);
+			drawing_t intersected(tiling);
+			Assert::IsTrue(multigrid.generate(bounds, intersected, never));
+			Assert::IsTrue(multigrid.used_fallback());
+
+			Assert::AreEqual(scanned.my_vertex_storage.size(), intersected.my_vertex_storage.size());
+			for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+				Assert::AreEqual(scanned.my_tile_storage[comb].size(), intersected.my_tile_storage[comb].size());
+		}
+	};
+}
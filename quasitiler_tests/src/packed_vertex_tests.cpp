@@ -0,0 +1,87 @@
+#include <dak/quasitiler/packed_vertex.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(packed_vertex_tests)
+	{
+	public:
+
+		TEST_METHOD(keys_keep_vertex_order)
+		{
+			const int dim = 5;
+			int bounds[2][vertex_t::MAX_DIM] =
+			{
+				{ -30, -7, 0, -100, 5, 0, 0, 0 },
+				{  30,  7, 9,  100, 6, 0, 0, 0 },
+			};
+			const vertex_packing_t packing(bounds, dim);
+			Assert::IsTrue(packing.fits());
+
+			std::mt19937 random(3);
+			std::vector<vertex_t> vertices;
+			for (int index = 0; index < 1000; ++index)
+			{
+				vertex_t vertex;
+				for (int ind = 0; ind < dim; ++ind)
+					vertex.coords[ind] = std::uniform_int_distribution<int>(bounds[0][ind], bounds[1][ind])(random);
+				vertices.emplace_back(vertex);
+			}
+
+			std::vector<uint64_t> keys;
+			for (const vertex_t& vertex : vertices)
+			{
+				keys.emplace_back(packing.pack(vertex));
+				Assert::IsTrue(packing.unpack(keys.back()) == vertex);
+			}
+
+			std::sort(vertices.begin(), vertices.end());
+			std::sort(keys.begin(), keys.end());
+			for (size_t index = 0; index < keys.size(); ++index)
+				Assert::IsTrue(packing.unpack(keys[index]) == vertices[index]);
+
+			// Stepping along a coordinate stays in its lane, even past the bounds.
+			vertex_t corner;
+			for (int ind = 0; ind < dim; ++ind)
+				corner.coords[ind] = bounds[1][ind];
+			vertex_t beyond = corner;
+			beyond.coords[2] += 1;
+			Assert::IsTrue(packing.unpack(packing.pack(corner) + packing.unit(2)) == beyond);
+		}
+
+		TEST_METHOD(list_falls_back_to_full_vertices)
+		{
+			int bounds[2][vertex_t::MAX_DIM] =
+			{
+				{ -2, -2, -2, 0, 0, 0, 0, 0 },
+				{  2,  2,  2, 0, 0, 0, 0, 0 },
+			};
+
+			packed_vertex_list_t list;
+			list.set_packing(vertex_packing_t(bounds, 3));
+			Assert::IsTrue(list.is_packed());
+
+			vertex_t inside;
+			inside.coords[0] = 1;
+			list.push_back(inside);
+			Assert::IsTrue(list.is_packed());
+
+			vertex_t outside;
+			outside.coords[1] = 10;
+			list.push_back(outside);
+			Assert::IsFalse(list.is_packed());
+			Assert::AreEqual(size_t(2), list.size());
+			Assert::IsTrue(list[0] == inside);
+			Assert::IsTrue(list[1] == outside);
+		}
+	};
+}
@@ -0,0 +1,96 @@
+#include <dak/quasitiler/projection_kernel.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(projection_kernel_tests)
+	{
+	public:
+
+		TEST_METHOD(all_kernels_agree)
+		{
+			std::mt19937 random(11);
+			std::uniform_real_distribution<double> coefficient(-1., 1.);
+			// Small enough for the points of all dimensions to fit packed keys.
+			constexpr int max_coordinate = 50;
+			std::uniform_int_distribution<int> coordinate(-max_coordinate, max_coordinate);
+
+			for (int dim = 3; dim <= projection_t::MAX_DIM; ++dim)
+			{
+				// The generic kernels and the ones specialized for the dimension.
+				std::vector<const projection_kernel_t*> kernels;
+				for (int kernel_dim : { 0, dim })
+				{
+					kernels.emplace_back(&get_scalar_projection_kernel(kernel_dim));
+					if (auto kernel = get_avx2_projection_kernel(kernel_dim))
+						kernels.emplace_back(kernel);
+				}
+
+				projection_t projection;
+				projection.dimensions_count = dim;
+				for (int ind = 0; ind < dim; ++ind)
+				{
+					projection.x_generator[ind] = coefficient(random);
+					projection.y_generator[ind] = coefficient(random);
+					projection.offsets[ind] = coefficient(random);
+				}
+
+				// A count that is not a multiple of the vector width, to also project the tail.
+				std::vector<vertex_t> points(1003);
+				for (vertex_t& point : points)
+					for (int ind = 0; ind < dim; ++ind)
+						point.coords[ind] = coordinate(random);
+
+				std::vector<double> expected_xs(points.size());
+				std::vector<double> expected_ys(points.size());
+				for (size_t index = 0; index < points.size(); ++index)
+				{
+					double x = 0.0;
+					double y = 0.0;
+					for (int ind = 0; ind < dim; ++ind)
+					{
+						x += (points[index].coords[ind] - projection.offsets[ind]) * projection.x_generator[ind];
+						y += (points[index].coords[ind] - projection.offsets[ind]) * projection.y_generator[ind];
+					}
+					expected_xs[index] = x;
+					expected_ys[index] = y;
+				}
+
+				int bounds[2][vertex_t::MAX_DIM] = { };
+				for (int ind = 0; ind < dim; ++ind)
+				{
+					bounds[0][ind] = -max_coordinate;
+					bounds[1][ind] = max_coordinate;
+				}
+				const vertex_packing_t packing(bounds, dim);
+				Assert::IsTrue(packing.fits());
+				std::vector<vertex_packing_t::key_t> keys;
+				for (const vertex_t& point : points)
+					keys.emplace_back(packing.pack(point));
+
+				for (const projection_kernel_t* kernel : kernels)
+				{
+					std::vector<double> xs(points.size());
+					std::vector<double> ys(points.size());
+					kernel->project(projection, points.data(), points.size(), xs.data(), ys.data());
+					Assert::IsTrue(xs == expected_xs);
+					Assert::IsTrue(ys == expected_ys);
+
+					std::vector<double> key_xs(points.size());
+					std::vector<double> key_ys(points.size());
+					kernel->project_keys(projection, packing, keys.data(), keys.size(), key_xs.data(), key_ys.data());
+					Assert::IsTrue(key_xs == expected_xs);
+					Assert::IsTrue(key_ys == expected_ys);
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,74 @@
+#include <dak/quasitiler/radix_sort.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(radix_sort_tests)
+	{
+	public:
+
+		TEST_METHOD(keys_match_std_sort)
+		{
+			std::mt19937_64 random(5);
+			for (int bits : { 1, 7, 11, 12, 23, 45, 64 })
+			{
+				for (size_t count : { size_t(0), size_t(10), size_t(1000), size_t(300000) })
+				{
+					std::vector<uint64_t> keys(count);
+					for (uint64_t& key : keys)
+						key = bits == 64 ? random() : random() & ((uint64_t(1) << bits) - 1);
+
+					std::vector<uint64_t> expected = keys;
+					std::sort(expected.begin(), expected.end());
+
+					for (int thread_count : { 1, 3 })
+					{
+						std::vector<uint64_t> sorted = keys;
+						radix_sort(sorted, bits, thread_count);
+						Assert::IsTrue(expected == sorted);
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(vertices_match_std_sort)
+		{
+			std::mt19937 random(7);
+			for (int dim = 3; dim <= vertex_t::MAX_DIM; ++dim)
+			{
+				for (size_t count : { size_t(10), size_t(5000), size_t(200000) })
+				{
+					// Some coordinates with a wide range, some constant.
+					std::vector<vertex_t> vertices(count);
+					for (vertex_t& vertex : vertices)
+					{
+						for (int ind = 0; ind < dim; ++ind)
+						{
+							const int range = (ind == 1) ? 0 : (ind == 2) ? 100000 : 40;
+							vertex.coords[ind] = std::uniform_int_distribution<int>(-range, range)(random);
+						}
+					}
+
+					std::vector<vertex_t> expected = vertices;
+					std::sort(expected.begin(), expected.end());
+
+					for (int thread_count : { 1, 4 })
+					{
+						std::vector<vertex_t> sorted = vertices;
+						radix_sort(sorted, dim, thread_count);
+						Assert::IsTrue(expected == sorted);
+					}
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,129 @@
+#include <dak/quasitiler/rasterizer.h>
+#include <dak/quasitiler/png_writer.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(rasterizer_tests)
+	{
+	public:
+
+		static std::string read_file(const std::filesystem::path& a_file_name)
+		{
+			std::ifstream stream(a_file_name, std::ios::binary);
+			std::ostringstream content;
+			content << stream.rdbuf();
+			return content.str();
+		}
+
+		static std::uint32_t read_u32(const std::string& a_data, size_t a_position)
+		{
+			return (std::uint32_t(std::uint8_t(a_data[a_position])) << 24)
+			     | (std::uint32_t(std::uint8_t(a_data[a_position + 1])) << 16)
+			     | (std::uint32_t(std::uint8_t(a_data[a_position + 2])) << 8)
+			     |  std::uint32_t(std::uint8_t(a_data[a_position + 3]));
+		}
+
+		// Verify the PNG signature, the image size and that the chunks
+		// follow each other up to the end chunk.
+		static void verify_png(const std::string& a_png, std::uint32_t a_width, std::uint32_t a_height)
+		{
+			Assert::IsTrue(a_png.starts_with("\x89PNG\r\n\x1A\n"));
+			Assert::IsTrue(a_png.substr(12, 4) == "IHDR");
+			Assert::AreEqual(a_width, read_u32(a_png, 16));
+			Assert::AreEqual(a_height, read_u32(a_png, 20));
+
+			size_t position = 8;
+			std::string type;
+			while (position + 12 <= a_png.size())
+			{
+				const std::uint32_t size = read_u32(a_png, position);
+				type = a_png.substr(position + 4, 4);
+				position += 12 + size;
+			}
+			Assert::AreEqual(a_png.size(), position);
+			Assert::IsTrue(type == "IEND");
+		}
+
+		TEST_METHOD(tile_colors_interpolate_groups)
+		{
+			tile_group_colors_t colors;
+			get_default_tile_group_colors(colors);
+
+			std::uint32_t tile_colors[tiling_t::MAX_TILE_COMB];
+			interpolate_tile_colors(5, colors, tile_colors);
+
+			// First and last combinations of the first group get its two colors.
+			Assert::AreEqual(colors[0][0], tile_colors[0]);
+			Assert::AreEqual(colors[0][1], tile_colors[4]);
+			Assert::AreEqual(colors[1][0], tile_colors[5]);
+			Assert::AreEqual(std::uint32_t(0), tile_colors[10]);
+		}
+
+		TEST_METHOD(png_writer_writes_all_rows)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_png_writer.png";
+
+			png_writer_t writer;
+			Assert::IsTrue(writer.open(file_name, 300, 7));
+			std::vector<std::uint8_t> row(300 * 3);
+			for (int y = 0; y < 7; ++y)
+			{
+				for (size_t x = 0; x < row.size(); ++x)
+					row[x] = std::uint8_t(x / 50 + y);
+				writer.write_row(row.data());
+			}
+			Assert::IsTrue(writer.close());
+			verify_png(read_file(file_name), 300, 7);
+
+			// Missing rows are reported.
+			Assert::IsTrue(writer.open(file_name, 300, 7));
+			writer.write_row(row.data());
+			Assert::IsFalse(writer.close());
+
+			std::filesystem::remove(file_name);
+		}
+
+		TEST_METHOD(bands_do_not_depend_on_threads)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_raster.png";
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] = { { -6., -5., }, { 5., 6., } };
+
+			auto tiling = std::make_shared<tiling_t>(7);
+			Assert::IsTrue(tiling->init(offsets));
+
+			never_interrupted_t never;
+			drawing_t drawing(tiling);
+			Assert::IsTrue(tiling->generate(bounds, drawing, never));
+			Assert::IsTrue(drawing.locate_tiles(never));
+
+			for (const bool antialias : { false, true })
+			{
+				raster_style_t style;
+				style.tile_size = 10.;
+				style.band_height = 7;
+				style.antialias = antialias;
+
+				Assert::IsTrue(write_png_file(file_name, drawing, bounds, style, 1));
+				const std::string single = read_file(file_name);
+				verify_png(single, 110, 110);
+
+				Assert::IsTrue(write_png_file(file_name, drawing, bounds, style, 3));
+				Assert::IsTrue(single == read_file(file_name));
+			}
+
+			std::filesystem::remove(file_name);
+		}
+	};
+}
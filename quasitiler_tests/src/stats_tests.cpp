@@ -0,0 +1,90 @@
+#include <dak/quasitiler/stats.h>
+#include <dak/quasitiler/drawing.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(stats_tests)
+	{
+	public:
+
+		TEST_METHOD(generate_stats_add_up)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] = { { -8., -8., }, { 8., 8., } };
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				tiling_t tiling(dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				for (int thread_count : { 1, 3 })
+				{
+					never_interrupted_t never;
+					points_t points;
+					Assert::IsTrue(tiling.generate(bounds, points, never, thread_count));
+
+					const generate_stats_t& stats = tiling.get_generate_stats();
+					if (!STATS_ENABLED)
+					{
+						Assert::AreEqual(std::uint64_t(0), stats.candidates);
+						continue;
+					}
+
+					// Each candidate is decided once, by the balls of the window or
+					// by the criteria, and each criteria reject has its criterion.
+					std::uint64_t criterion_rejects = 0;
+					for (int criterion = 0; criterion < stats.criteria_count; ++criterion)
+						criterion_rejects += stats.criterion_rejects[criterion];
+
+					Assert::AreEqual(std::uint64_t(points.points.size()), stats.accepted);
+					Assert::AreEqual(stats.candidates, stats.inner_accepts + stats.outer_rejects + stats.criteria_tests);
+					Assert::AreEqual(stats.accepted, stats.inner_accepts + stats.criteria_tests - stats.criteria_rejects);
+					Assert::AreEqual(stats.criteria_rejects, criterion_rejects);
+					Assert::IsTrue(stats.exact_tests <= stats.criteria_tests);
+					Assert::IsTrue(stats.clipped_plane_points <= stats.plane_points);
+				}
+			}
+		}
+
+		TEST_METHOD(locate_stats_add_up)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] = { { -8., -8., }, { 8., 8., } };
+
+			auto tiling = std::make_shared<tiling_t>(5);
+			Assert::IsTrue(tiling->init(offsets));
+
+			for (auto search : { drawing_t::tile_search_t::hashed, drawing_t::tile_search_t::sorted })
+			{
+				never_interrupted_t never;
+				drawing_t drawing(tiling);
+				drawing.set_tile_search(search);
+				Assert::IsTrue(tiling->generate(bounds, drawing, never));
+				Assert::IsTrue(drawing.locate_tiles(never));
+
+				const locate_stats_t& stats = drawing.get_locate_stats();
+				if (!STATS_ENABLED)
+				{
+					Assert::AreEqual(std::uint64_t(0), stats.neighbor_lookups);
+					continue;
+				}
+
+				size_t tile_count = 0;
+				for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+					tile_count += drawing.get_tile_storage()[comb].size();
+
+				Assert::AreEqual(std::uint64_t(drawing.get_vertex_storage().size()), stats.vertices);
+				Assert::AreEqual(stats.vertices * 5, stats.neighbor_lookups);
+				Assert::AreEqual(std::uint64_t(tile_count), stats.tiles);
+				Assert::IsTrue(stats.neighbors_found <= stats.neighbor_lookups);
+				Assert::AreEqual(search == drawing_t::tile_search_t::sorted, stats.binary_search_probes > 0);
+			}
+		}
+	};
+}
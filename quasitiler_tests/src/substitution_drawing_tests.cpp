@@ -0,0 +1,104 @@
+#include <dak/quasitiler/substitution_drawing.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(substitution_drawing_tests)
+	{
+	public:
+
+		TEST_METHOD(substitution_matches_scan)
+		{
+			const double all_offsets[2][tiling_t::MAX_DIM] =
+			{
+				{ 0. },
+				{ 0., 0., 0.1, 0.2, 0.3, },
+			};
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -30., -25., },
+				{  28.,  31., },
+			};
+
+			for (int dim = 3; dim <= 5; ++dim)
+			{
+				for (const auto& some_offsets : all_offsets)
+				{
+					double offsets[tiling_t::MAX_DIM];
+					std::copy(some_offsets, some_offsets + tiling_t::MAX_DIM, offsets);
+
+					auto tiling = std::make_shared<tiling_t>(dim);
+					Assert::IsTrue(tiling->init(offsets));
+
+					never_interrupted_t never;
+					drawing_t scanned(tiling);
+					Assert::IsTrue(tiling->generate(bounds, scanned, never));
+					Assert::IsTrue(scanned.locate_tiles(never));
+
+					substitution_drawing_t substitution(tiling);
+					drawing_t inflated(tiling);
+					Assert::IsTrue(substitution.generate(bounds, inflated, never));
+					Assert::IsFalse(substitution.used_fallback());
+					Assert::IsTrue(tiling->is_generated());
+
+					// The scan and the inflation clip the vertices slightly
+					// differently, so compare the tiles well inside the bounds.
+					const double inner[2][tiling_t::MAX_DIM] =
+					{
+						{ -26., -21., },
+						{  24.,  27., },
+					};
+					const tiles_t scanned_tiles = tiles_within(scanned, inner);
+					Assert::IsFalse(scanned_tiles.empty());
+					Assert::IsTrue(scanned_tiles == tiles_within(inflated, inner));
+
+					// The vertices are all distinct.
+					std::vector<vertex_t> vertices;
+					for (size_t index = 0; index < inflated.my_vertex_storage.size(); ++index)
+						vertices.emplace_back(inflated.my_vertex_storage[index]);
+					std::sort(vertices.begin(), vertices.end());
+					Assert::IsTrue(std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end());
+				}
+			}
+		}
+
+		TEST_METHOD(no_inflation_falls_back_to_scan)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -8., -8., },
+				{  8.,  8., },
+			};
+
+			// From dimension 6, the inflation no longer maps the window into itself.
+			for (int dim = 6; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				auto tiling = std::make_shared<tiling_t>(dim);
+				Assert::IsTrue(tiling->init(offsets));
+
+				never_interrupted_t never;
+				drawing_t scanned(tiling);
+				Assert::IsTrue(tiling->generate(bounds, scanned, never));
+				Assert::IsTrue(scanned.locate_tiles(never));
+
+				substitution_drawing_t substitution(tiling);
+				drawing_t generated(tiling);
+				Assert::IsTrue(substitution.generate(bounds, generated, never));
+				Assert::IsTrue(substitution.used_fallback());
+
+				Assert::AreEqual(scanned.my_vertex_storage.size(), generated.my_vertex_storage.size());
+				for (int comb = 0; comb < tiling->tile_combinations_count(); ++comb)
+					Assert::AreEqual(scanned.my_tile_storage[comb].size(), generated.my_tile_storage[comb].size());
+			}
+		}
+	};
+}
@@ -0,0 +1,129 @@
+#include <dak/quasitiler/svg_writer.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(svg_writer_tests)
+	{
+	public:
+
+		static std::string read_file(const std::filesystem::path& a_file_name)
+		{
+			std::ifstream stream(a_file_name, std::ios::binary);
+			std::ostringstream content;
+			content << stream.rdbuf();
+			return content.str();
+		}
+
+		static size_t count_tiles(const drawing_t& a_drawing)
+		{
+			size_t tile_count = 0;
+			for (int comb = 0; comb < a_drawing.get_tiling()->tile_combinations_count(); ++comb)
+				tile_count += a_drawing.my_tile_storage[comb].size();
+			return tile_count;
+		}
+
+		TEST_METHOD(buffered_writer_keeps_order)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_buffered_writer.txt";
+
+			// Tiny buffers, so that many are handed to the background thread.
+			std::string expected;
+			{
+				buffered_writer_t writer(16, 2);
+				Assert::IsTrue(writer.open(file_name));
+				for (int index = 0; index < 10000; ++index)
+				{
+					const std::string line = std::to_string(index) + "\n";
+					writer.write(line);
+					expected += line;
+				}
+				Assert::IsTrue(writer.close());
+				Assert::IsFalse(writer.is_open());
+			}
+
+			Assert::IsTrue(expected == read_file(file_name));
+			std::filesystem::remove(file_name);
+		}
+
+		TEST_METHOD(writes_each_tile_once)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_tiles.svg";
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] = { { -8., -6., }, { 7., 8., } };
+
+			auto tiling = std::make_shared<tiling_t>(5);
+			Assert::IsTrue(tiling->init(offsets));
+
+			never_interrupted_t never;
+			drawing_t drawing(tiling);
+			Assert::IsTrue(tiling->generate(bounds, drawing, never));
+			Assert::IsTrue(drawing.locate_tiles(never));
+			Assert::IsTrue(write_svg_file(file_name, drawing, bounds));
+
+			const std::string svg = read_file(file_name);
+			Assert::IsTrue(svg.starts_with("<?xml"));
+			Assert::IsTrue(svg.ends_with("</svg>\n"));
+			Assert::AreEqual(count_tiles(drawing), size_t(std::count(svg.begin(), svg.end(), 'M')));
+			Assert::AreEqual(size_t(tiling->tile_combinations_count()), size_t(std::count(svg.begin(), svg.end(), '{')) - 1);
+
+			// The same tile colors as the other outputs.
+			tile_group_colors_t group_colors;
+			get_default_tile_group_colors(group_colors);
+			std::uint32_t tile_colors[tiling_t::MAX_TILE_COMB];
+			interpolate_tile_colors(tiling->dimensions_count(), group_colors, tile_colors);
+			char fill[32];
+			std::snprintf(fill, sizeof(fill), ".c1 { fill: #%06x; }", unsigned(tile_colors[1]));
+			Assert::IsTrue(svg.find(fill) != std::string::npos);
+
+			std::filesystem::remove(file_name);
+		}
+
+		TEST_METHOD(writes_chunks_as_located)
+		{
+			const auto file_name = std::filesystem::temp_directory_path() / "quasitiler_chunks.svg";
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] = { { -12., -9., }, { 11., 13., } };
+
+			auto tiling = std::make_shared<tiling_t>(7);
+			Assert::IsTrue(tiling->init(offsets));
+
+			never_interrupted_t never;
+			chunked_drawing_t whole(tiling);
+			chunked_drawing_t chunked(tiling);
+			whole.set_chunk_size(0.);
+			chunked.set_chunk_size(5.);
+
+			// Count the tiles of the whole drawing with a writer of the single chunk.
+			struct tile_counter_t : chunk_reporter_t
+			{
+				size_t tile_count = 0;
+				void report_chunk(const drawing_t& a_chunk) override { tile_count += count_tiles(a_chunk); }
+			} counter;
+			Assert::IsTrue(whole.generate(bounds, counter, never));
+
+			svg_writer_t writer(tiling);
+			Assert::IsTrue(writer.open(file_name, bounds));
+			Assert::IsTrue(chunked.generate(bounds, writer, never));
+			Assert::IsTrue(writer.close());
+
+			const std::string svg = read_file(file_name);
+			Assert::IsTrue(svg.ends_with("</svg>\n"));
+			Assert::AreEqual(counter.tile_count, size_t(std::count(svg.begin(), svg.end(), 'M')));
+
+			std::filesystem::remove(file_name);
+		}
+	};
+}
@@ -3,6 +3,8 @@
 
 #include "CppUnitTest.h"
 
+#include <algorithm>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace dak::quasitiler;
 
@@ -17,5 +19,166 @@ namespace dak::quasitiler::tests
          // TODO: tiling tests.
 		}
 
+		TEST_METHOD(parallel_generate_matches_serial)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -10., -10., -10., -10., -10., -10., -10., -10., },
+				{  10.,  10.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				tiling_t tiling(dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				never_interrupted_t never;
+				points_t serial;
+				Assert::IsTrue(tiling.generate(bounds, serial, never));
+
+				for (int thread_count : { 2, 3, 8 })
+				{
+					points_t parallel;
+					Assert::IsTrue(tiling.generate(bounds, parallel, never, thread_count));
+					Assert::IsTrue(serial.points == parallel.points);
+				}
+			}
+		}
+
+		TEST_METHOD(static_reporter_matches_virtual)
+		{
+			// Reporter without virtual functions, used through generate<REPORTER>().
+			struct static_points_t
+			{
+				std::vector<vertex_t> points;
+
+				void report_point(const vertex_t& a_point) { points.emplace_back(a_point); }
+			};
+
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -10., -10., -10., -10., -10., -10., -10., -10., },
+				{  10.,  10.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				tiling_t tiling(dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				never_interrupted_t never;
+				points_t batched;
+				static_points_t inlined;
+				Assert::IsTrue(tiling.generate(bounds, batched, never));
+				Assert::IsTrue(tiling.generate(bounds, inlined, never));
+				Assert::IsTrue(batched.points == inlined.points);
+			}
+		}
+
+		TEST_METHOD(adaptive_criteria_order_keeps_points)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -40., -40., -40., -40., -40., -40., -40., -40., },
+				{  40.,  40.,  40.,  40.,  40.,  40.,  40.,  40., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				tiling_t tiling(dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				never_interrupted_t never;
+				points_t fixed;
+				Assert::IsTrue(tiling.generate(bounds, fixed, never));
+
+				tiling.set_criteria_order(tiling_t::criteria_order_t::adaptive);
+				for (int thread_count : { 1, 3 })
+				{
+					points_t adaptive;
+					Assert::IsTrue(tiling.generate(bounds, adaptive, never, thread_count));
+					Assert::IsTrue(fixed.points == adaptive.points);
+				}
+
+				// Going back to the fixed order.
+				tiling.set_criteria_order(tiling_t::criteria_order_t::fixed);
+				points_t fixed_again;
+				Assert::IsTrue(tiling.generate(bounds, fixed_again, never));
+				Assert::IsTrue(fixed.points == fixed_again.points);
+			}
+		}
+
+		TEST_METHOD(lazy_vertices_match_generate)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -10., -10., -10., -10., -10., -10., -10., -10., },
+				{  10.,  10.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				tiling_t tiling(dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				never_interrupted_t never;
+				points_t generated;
+				Assert::IsTrue(tiling.generate(bounds, generated, never));
+
+				std::vector<vertex_t> lazy;
+				for (const vertex_t& point : tiling.vertices(bounds))
+					lazy.emplace_back(point);
+				Assert::IsTrue(tiling.is_generated());
+				Assert::IsTrue(generated.points == lazy);
+			}
+		}
+
+		TEST_METHOD(lazy_vertices_pause_and_resume)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+			double bounds[2][tiling_t::MAX_DIM] =
+			{
+				{ -10., -10., -10., -10., -10., -10., -10., -10., },
+				{  10.,  10.,  10.,  10.,  10.,  10.,  10.,  10., },
+			};
+
+			tiling_t tiling(5);
+			Assert::IsTrue(tiling.init(offsets));
+
+			never_interrupted_t never;
+			points_t generated;
+			Assert::IsTrue(tiling.generate(bounds, generated, never));
+
+			// Take a few points at a time, then leave a loop early and resume.
+			vertex_generator_t vertices = tiling.vertices(bounds);
+			points_t lazy;
+			Assert::AreEqual(size_t(7), vertices.take_points(lazy, 7));
+			Assert::IsFalse(tiling.is_generated());
+
+			for (const vertex_t& point : vertices)
+			{
+				lazy.points.emplace_back(point);
+				if (lazy.points.size() == 100)
+					break;
+			}
+
+			while (vertices.take_points(lazy, 50) == 50)
+				Assert::IsFalse(vertices.is_done());
+
+			Assert::IsTrue(vertices.is_done());
+			Assert::AreEqual(size_t(0), vertices.take_points(lazy, 50));
+			Assert::IsTrue(tiling.is_generated());
+			Assert::IsTrue(generated.points == lazy.points);
+
+			// Stopping early and starting over.
+			vertex_generator_t first = tiling.vertices(bounds);
+			points_t first_points;
+			first.take_points(first_points, 10);
+			Assert::IsTrue(std::equal(first_points.points.begin(), first_points.points.end(), generated.points.begin()));
+		}
 	};
 }
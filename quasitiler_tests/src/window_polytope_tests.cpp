@@ -0,0 +1,73 @@
+#include <dak/quasitiler/tiling.h>
+#include <dak/quasitiler/window_polytope.h>
+#include <dak/quasitiler_tests/helpers.h>
+
+#include "CppUnitTest.h"
+
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace dak::quasitiler;
+
+namespace dak::quasitiler::tests
+{
+	TEST_CLASS(window_polytope_tests)
+	{
+	public:
+
+		TEST_METHOD(symmetric_windows)
+		{
+			// The window of the Ammann-Beenker tiling is an octagon and the one
+			// of the Penrose tiling is a rhombic icosahedron.
+			struct expected_t { int dim; size_t facets; size_t vertices; };
+			for (const expected_t& expected : { expected_t{ 3, 2, 2 }, expected_t{ 4, 8, 8 }, expected_t{ 5, 20, 22 } })
+			{
+				double offsets[tiling_t::MAX_DIM] = { 0. };
+				tiling_t tiling(expected.dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				const window_polytope_t& window = tiling.get_window_polytope();
+				Assert::AreEqual(expected.dim - 2, window.window_dimensions_count());
+				Assert::AreEqual(expected.facets, window.get_facets().size());
+				Assert::AreEqual(expected.vertices, window.get_vertices().size());
+			}
+		}
+
+		TEST_METHOD(facets_bound_the_window)
+		{
+			double offsets[tiling_t::MAX_DIM] = { 0., 0., 0.1, 0.2, 0.3, 0.05, 0.15, 0.25 };
+
+			for (int dim = 3; dim <= tiling_t::MAX_DIM; ++dim)
+			{
+				tiling_t tiling(dim);
+				Assert::IsTrue(tiling.init(offsets));
+
+				// One pair of opposite facets per criterion of the cylinder.
+				const window_polytope_t& window = tiling.get_window_polytope();
+				const int criteria_count = dim * (dim - 1) * (dim - 2) / 6;
+				Assert::AreEqual(size_t(2 * criteria_count), window.get_facets().size());
+
+				for (const window_polytope_t::facet_t& facet : window.get_facets())
+				{
+					// All vertices are inside the facet, those of the facet on it.
+					for (size_t vertex = 0; vertex < window.get_vertices().size(); ++vertex)
+					{
+						double along = 0.;
+						for (int coord = 0; coord < window.window_dimensions_count(); ++coord)
+							along += facet.normal.coords[coord] * window.get_vertices()[vertex].coords[coord];
+
+						const double ratio = along / facet.distance;
+						Assert::IsTrue(ratio < 1. + 1e-9);
+						const bool is_on_facet = std::find(facet.vertices.begin(), facet.vertices.end(), int(vertex)) != facet.vertices.end();
+						Assert::AreEqual(is_on_facet, ratio > 1. - 1e-9);
+					}
+
+					Assert::IsTrue(facet.vertices.size() >= size_t(dim - 2));
+				}
+
+				Assert::IsTrue(window.get_inner_radius() > 0.);
+				Assert::IsTrue(window.get_inner_radius() <= window.get_outer_radius());
+			}
+		}
+	};
+}